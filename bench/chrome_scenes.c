@@ -0,0 +1,79 @@
+#include "plot_scenes.h"
+#include "plot.h"
+
+// The watchface decoration that is cached in PlotChrome bitmaps: the heart
+// glyph and the day graph's frame and grid.  The bpm and precipitation
+// graphs draw their few lines directly, as in plot_scenes.c.  plot_check
+// compares these with the directly drawn reference scenes.
+
+#define CHROME_HEART_FRAME GRect(0, 0, 9, 14)
+#define CHROME_DAY_FRAME GRect(0, 0, SCENE_DAY_SAMPLES+2, 27)
+
+static PlotChrome s_heart_chrome;
+static PlotChrome s_day_chrome;
+
+static void heart_chrome(PlotChrome* chrome, GRect bounds) {
+    (void)bounds;
+    plot_chrome_fill_rect(chrome, GRect(1, 3, 2, 1), GColorRed);
+    plot_chrome_fill_rect(chrome, GRect(5, 3, 2, 1), GColorRed);
+    plot_chrome_fill_rect(chrome, GRect(0, 4, 8, 2), GColorRed);
+    plot_chrome_fill_rect(chrome, GRect(1, 6, 6, 1), GColorRed);
+    plot_chrome_fill_rect(chrome, GRect(2, 7, 4, 1), GColorRed);
+    plot_chrome_fill_rect(chrome, GRect(3, 8, 2, 1), GColorRed);
+    plot_chrome_fill_rect(chrome, GRect(4, 9, 1, 1), GColorRed);
+}
+
+static PlotLayout day_layout(GRect bounds) {
+    return plot_layout(bounds, 1, 1, 1, 1, 0, 100);
+}
+
+static void day_chrome(PlotChrome* chrome, GRect bounds) {
+    static const int16_t grid_lines[] = {12, 24, 36};
+    PlotLayout plot = day_layout(bounds);
+    plot_chrome_draw_frame(chrome, &plot, GColorWhite);
+    plot_chrome_draw_vertical_lines(chrome, &plot, grid_lines,
+                                    ARRAY_LENGTH(grid_lines),
+                                    GColorDarkGray, 0, 0);
+}
+
+void chrome_scenes_init(void) {
+    plot_chrome_init(&s_heart_chrome, CHROME_HEART_FRAME.size, heart_chrome);
+    plot_chrome_init(&s_day_chrome, CHROME_DAY_FRAME.size, day_chrome);
+}
+
+void chrome_scenes_deinit(void) {
+    plot_chrome_deinit(&s_heart_chrome);
+    plot_chrome_deinit(&s_day_chrome);
+}
+
+void chrome_scene_draw_heart(GContext* ctx) {
+    plot_chrome_draw(ctx, &s_heart_chrome, CHROME_HEART_FRAME);
+}
+
+void chrome_scene_draw_day_graph(GContext* ctx, uint16_t half_hour_offset) {
+    PlotLayout plot = day_layout(CHROME_DAY_FRAME);
+    bool has_temp = plot_has_u8_values(&plot, g_scene_day_atemp_array,
+                                       SCENE_DAY_SAMPLES, half_hour_offset,
+                                       SCENE_DAY_UNKNOWN);
+    bool has_precip = plot_has_u8_values(&plot, g_scene_day_precip_array,
+                                         SCENE_DAY_SAMPLES, half_hour_offset,
+                                         SCENE_DAY_UNKNOWN);
+    if (!has_temp && !has_precip) {
+        return;
+    }
+
+    if (has_precip) {
+        plot_draw_u8_filled_line(ctx, &plot, g_scene_day_precip_array,
+                                 SCENE_DAY_SAMPLES, half_hour_offset,
+                                 SCENE_DAY_UNKNOWN, 0, true, GColorCyan);
+    }
+    plot_chrome_draw(ctx, &s_day_chrome, CHROME_DAY_FRAME);
+    if (has_temp) {
+        plot_set_y_range_from_u8(&plot, g_scene_day_atemp_array,
+                                 SCENE_DAY_SAMPLES, half_hour_offset,
+                                 SCENE_DAY_UNKNOWN, -100);
+        plot_draw_u8_line(ctx, &plot, g_scene_day_atemp_array,
+                          SCENE_DAY_SAMPLES, half_hour_offset,
+                          SCENE_DAY_UNKNOWN, -100, GColorRed);
+    }
+}
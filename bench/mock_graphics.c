@@ -0,0 +1,194 @@
+#include <stdlib.h>
+
+#include "mock_graphics.h"
+
+bool g_mock_graphics_fail_bitmaps;
+bool g_mock_graphics_fail_capture;
+
+// Counts a draw call; drawing through the context while the framebuffer is
+// captured is a bug in the caller.
+static void mock_count(GContext* ctx, uint32_t* counter) {
+    *counter += 1;
+    if (ctx->framebuffer_captured) { ctx->counts.draws_while_captured += 1; }
+}
+
+static void mock_set_pixel(GContext* ctx, int x, int y, GColor color) {
+    if (!ctx->rasterize) { return; }
+    if (ctx->layer_size.w > 0 &&
+        (x < 0 || y < 0 || x >= ctx->layer_size.w || y >= ctx->layer_size.h)) {
+        return;
+    }
+    x += ctx->origin.x;
+    y += ctx->origin.y;
+    if (x < 0 || y < 0 || x >= MOCK_SCREEN_WIDTH || y >= MOCK_SCREEN_HEIGHT) {
+        return;
+    }
+    ctx->framebuffer[y][x] = color.argb;
+}
+
+static int mock_abs(int value) { return value < 0 ? -value : value; }
+
+void mock_graphics_reset(GContext* ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+    memset(ctx->framebuffer, GColorBlack.argb, sizeof(ctx->framebuffer));
+    ctx->stroke_color = GColorBlack;
+    ctx->fill_color = GColorBlack;
+    ctx->rasterize = true;
+}
+
+uint32_t mock_graphics_draw_calls(const GContext* ctx) {
+    return ctx->counts.fill_rect + ctx->counts.draw_line +
+        ctx->counts.draw_rect + ctx->counts.draw_bitmap;
+}
+
+uint32_t mock_graphics_checksum(const GContext* ctx) {
+    // FNV-1a over the framebuffer.
+    uint32_t hash = 2166136261u;
+    const uint8_t* pixels = &ctx->framebuffer[0][0];
+    for (size_t i=0; i<sizeof(ctx->framebuffer); i++) {
+        hash = (hash ^ pixels[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool mock_graphics_equal(const GContext* a, const GContext* b) {
+    return memcmp(a->framebuffer, b->framebuffer, sizeof(a->framebuffer)) == 0;
+}
+
+void graphics_context_set_stroke_color(GContext* ctx, GColor color) {
+    ctx->stroke_color = color;
+}
+
+void graphics_context_set_fill_color(GContext* ctx, GColor color) {
+    ctx->fill_color = color;
+}
+
+void graphics_draw_line(GContext* ctx, GPoint p0, GPoint p1) {
+    mock_count(ctx, &ctx->counts.draw_line);
+    if (!ctx->rasterize) { return; }
+    int x = p0.x;
+    int y = p0.y;
+    int dx = mock_abs(p1.x-p0.x);
+    int dy = -mock_abs(p1.y-p0.y);
+    int sx = p0.x < p1.x ? 1 : -1;
+    int sy = p0.y < p1.y ? 1 : -1;
+    int err = dx+dy;
+    for (;;) {
+        mock_set_pixel(ctx, x, y, ctx->stroke_color);
+        if (x == p1.x && y == p1.y) { break; }
+        int e2 = 2*err;
+        if (e2 >= dy) { err += dy; x += sx; }
+        if (e2 <= dx) { err += dx; y += sy; }
+    }
+}
+
+void graphics_draw_rect(GContext* ctx, GRect rect) {
+    mock_count(ctx, &ctx->counts.draw_rect);
+    if (!ctx->rasterize) { return; }
+    int x1 = rect.origin.x;
+    int y1 = rect.origin.y;
+    int x2 = rect.origin.x + rect.size.w - 1;
+    int y2 = rect.origin.y + rect.size.h - 1;
+    for (int x=x1; x<=x2; x++) {
+        mock_set_pixel(ctx, x, y1, ctx->stroke_color);
+        mock_set_pixel(ctx, x, y2, ctx->stroke_color);
+    }
+    for (int y=y1; y<=y2; y++) {
+        mock_set_pixel(ctx, x1, y, ctx->stroke_color);
+        mock_set_pixel(ctx, x2, y, ctx->stroke_color);
+    }
+}
+
+void graphics_fill_rect(GContext* ctx, GRect rect, uint16_t corner_radius,
+                        GCornerMask corner_mask) {
+    (void)corner_radius;
+    (void)corner_mask;
+    mock_count(ctx, &ctx->counts.fill_rect);
+    if (!ctx->rasterize) { return; }
+    for (int y=rect.origin.y; y<rect.origin.y+rect.size.h; y++) {
+        for (int x=rect.origin.x; x<rect.origin.x+rect.size.w; x++) {
+            mock_set_pixel(ctx, x, y, ctx->fill_color);
+        }
+    }
+}
+
+void graphics_context_set_compositing_mode(GContext* ctx, GCompOp mode) {
+    ctx->compositing_mode = mode;
+}
+
+void graphics_draw_bitmap_in_rect(GContext* ctx, const GBitmap* bitmap,
+                                  GRect rect) {
+    mock_count(ctx, &ctx->counts.draw_bitmap);
+    if (!ctx->rasterize) { return; }
+    int w = rect.size.w < bitmap->bounds.size.w ? rect.size.w : bitmap->bounds.size.w;
+    int h = rect.size.h < bitmap->bounds.size.h ? rect.size.h : bitmap->bounds.size.h;
+    for (int y=0; y<h; y++) {
+        for (int x=0; x<w; x++) {
+            GColor color = {.argb = bitmap->pixels[y*bitmap->bounds.size.w + x]};
+            // GCompOpSet skips transparent pixels; partial alpha is not
+            // modelled.
+            if (ctx->compositing_mode == GCompOpSet && color.a == 0) { continue; }
+            mock_set_pixel(ctx, rect.origin.x+x, rect.origin.y+y, color);
+        }
+    }
+}
+
+GBitmap* gbitmap_create_blank(GSize size, GBitmapFormat format) {
+    if (g_mock_graphics_fail_bitmaps || format != GBitmapFormat8Bit ||
+        size.w <= 0 || size.h <= 0) {
+        return NULL;
+    }
+    GBitmap* bitmap = malloc(sizeof(GBitmap));
+    bitmap->bounds = GRect(0, 0, size.w, size.h);
+    bitmap->format = format;
+    bitmap->pixels = calloc((size_t)size.w*size.h, 1);
+    return bitmap;
+}
+
+void gbitmap_destroy(GBitmap* bitmap) {
+    free(bitmap->pixels);
+    free(bitmap);
+}
+
+GRect gbitmap_get_bounds(const GBitmap* bitmap) {
+    return bitmap->bounds;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap* bitmap,
+                                             uint16_t y) {
+    return (GBitmapDataRowInfo){
+        .data = bitmap->pixels + y*bitmap->bounds.size.w,
+        .min_x = 0,
+        .max_x = bitmap->bounds.size.w - 1
+    };
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap* bitmap) {
+    return bitmap->format;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap* bitmap) {
+    return bitmap->bounds.size.w;
+}
+
+GBitmap* graphics_capture_frame_buffer(GContext* ctx) {
+    if (g_mock_graphics_fail_capture || ctx->framebuffer_captured) {
+        return NULL;
+    }
+    ctx->counts.captures += 1;
+    ctx->framebuffer_captured = true;
+    ctx->framebuffer_bitmap = (GBitmap){
+        .bounds = GRect(0, 0, MOCK_SCREEN_WIDTH, MOCK_SCREEN_HEIGHT),
+        .format = GBitmapFormat8Bit,
+        .pixels = &ctx->framebuffer[0][0]
+    };
+    return &ctx->framebuffer_bitmap;
+}
+
+bool graphics_release_frame_buffer(GContext* ctx, GBitmap* buffer) {
+    if (!ctx->framebuffer_captured || buffer != &ctx->framebuffer_bitmap) {
+        return false;
+    }
+    ctx->framebuffer_captured = false;
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <pebble.h>
+
+#define MOCK_SCREEN_WIDTH 200
+#define MOCK_SCREEN_HEIGHT 228
+
+typedef struct {
+    uint32_t fill_rect;
+    uint32_t draw_line;
+    uint32_t draw_rect;
+    uint32_t draw_bitmap;
+    uint32_t captures;
+    uint32_t draws_while_captured; // Must stay 0.
+} MockDrawCounts;
+
+struct GBitmap {
+    GRect bounds;
+    GBitmapFormat format;
+    uint8_t* pixels; // bounds.size.w bytes per row.
+};
+
+struct GContext {
+    bool rasterize; // When false only the draw calls are counted.
+    GPoint origin;    // Screen position of the layer being drawn.
+    GSize layer_size; // Clips drawing to the layer when non-zero.
+    GColor stroke_color;
+    GColor fill_color;
+    GCompOp compositing_mode;
+    MockDrawCounts counts;
+    bool framebuffer_captured;
+    GBitmap framebuffer_bitmap;
+    uint8_t framebuffer[MOCK_SCREEN_HEIGHT][MOCK_SCREEN_WIDTH];
+};
+
+// When set, gbitmap_create_blank or graphics_capture_frame_buffer fail, to
+// exercise the fallbacks.
+extern bool g_mock_graphics_fail_bitmaps;
+extern bool g_mock_graphics_fail_capture;
+
+void mock_graphics_reset(GContext* ctx);
+uint32_t mock_graphics_draw_calls(const GContext* ctx);
+uint32_t mock_graphics_checksum(const GContext* ctx);
+bool mock_graphics_equal(const GContext* a, const GContext* b);
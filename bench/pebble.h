@@ -0,0 +1,94 @@
+#pragma once
+
+// Minimal host-side stand-in for the Pebble SDK header.  Only the parts of
+// the graphics API used by src/c/plot.c are declared; the implementation in
+// mock_graphics.c records every call and rasterizes it into a software
+// framebuffer sized like the emery display.  Bitmaps are 8-bit only.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct GPoint {
+    int16_t x;
+    int16_t y;
+} GPoint;
+
+typedef struct GSize {
+    int16_t w;
+    int16_t h;
+} GSize;
+
+typedef struct GRect {
+    GPoint origin;
+    GSize size;
+} GRect;
+
+typedef union GColor8 {
+    uint8_t argb;
+    struct {
+        uint8_t b:2;
+        uint8_t g:2;
+        uint8_t r:2;
+        uint8_t a:2;
+    };
+} GColor8;
+typedef GColor8 GColor;
+
+typedef enum {
+    GCornerNone = 0
+} GCornerMask;
+
+typedef enum {
+    GCompOpAssign,
+    GCompOpSet
+} GCompOp;
+
+typedef enum {
+    GBitmapFormat1Bit = 0,
+    GBitmapFormat8Bit = 1
+} GBitmapFormat;
+
+typedef struct GBitmapDataRowInfo {
+    uint8_t* data;
+    int16_t min_x;
+    int16_t max_x;
+} GBitmapDataRowInfo;
+
+typedef struct GContext GContext;
+typedef struct GBitmap GBitmap;
+
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define ARRAY_LENGTH(array) (sizeof((array))/sizeof((array)[0]))
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+
+#define GColorClear ((GColor8){.argb = 0x00})
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+#define GColorDarkGray ((GColor8){.argb = 0xD5})
+#define GColorRed ((GColor8){.argb = 0xF0})
+#define GColorCyan ((GColor8){.argb = 0xCF})
+
+void graphics_context_set_stroke_color(GContext* ctx, GColor color);
+void graphics_context_set_fill_color(GContext* ctx, GColor color);
+void graphics_draw_line(GContext* ctx, GPoint p0, GPoint p1);
+void graphics_draw_rect(GContext* ctx, GRect rect);
+void graphics_fill_rect(GContext* ctx, GRect rect, uint16_t corner_radius,
+                        GCornerMask corner_mask);
+void graphics_context_set_compositing_mode(GContext* ctx, GCompOp mode);
+void graphics_draw_bitmap_in_rect(GContext* ctx, const GBitmap* bitmap,
+                                  GRect rect);
+
+GBitmap* gbitmap_create_blank(GSize size, GBitmapFormat format);
+void gbitmap_destroy(GBitmap* bitmap);
+GRect gbitmap_get_bounds(const GBitmap* bitmap);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap* bitmap,
+                                             uint16_t y);
+GBitmapFormat gbitmap_get_format(const GBitmap* bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap* bitmap);
+
+GBitmap* graphics_capture_frame_buffer(GContext* ctx);
+bool graphics_release_frame_buffer(GContext* ctx, GBitmap* buffer);
@@ -0,0 +1,234 @@
+// Host-side timing of the plot.c primitives and of the three watchface
+// graphs.  Draw calls go to the counting mock backend with rasterization
+// disabled, so the timings cover plot.c itself rather than the mock
+// framebuffer.  The "raster" cases rasterize, to compare the filled plots
+// going through graphics_fill_rect with the direct framebuffer backend; the
+// mock's per-pixel fill_rect stands in for the firmware rasterizer there.
+// Host nanoseconds are only meaningful relative to each other; the
+// draw-call counts carry over to the watch directly.
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "plot.h"
+#include "plot_scenes.h"
+
+#define BENCH_DEFAULT_ITERATIONS 200000
+
+typedef struct {
+    const char* name;
+    void (*run)(GContext* ctx, uint32_t iteration);
+    bool rasterize;
+} BenchCase;
+
+static PlotLayout s_precip_plot;
+static PlotLayout s_day_plot;
+static PlotLayout s_bpm_plot;
+static PlotLayout s_precip_plot_framebuffer;
+static PlotLayout s_day_plot_framebuffer;
+static PlotLayout s_bpm_plot_framebuffer;
+static volatile uint32_t s_sink;
+
+static uint16_t bench_precip_offset(uint32_t iteration) {
+    return (uint16_t)(iteration % SCENE_PRECIP_SAMPLES);
+}
+
+static uint16_t bench_day_offset(uint32_t iteration) {
+    return (uint16_t)(iteration % SCENE_DAY_SAMPLES);
+}
+
+static void run_precip_filled_line(GContext* ctx, uint32_t iteration) {
+    s_sink += plot_draw_u8_filled_line(ctx, &s_precip_plot,
+                                       g_scene_precip_array,
+                                       SCENE_PRECIP_SAMPLES,
+                                       bench_precip_offset(iteration),
+                                       0, 0, true, GColorCyan);
+}
+
+static void run_day_precip_filled_line(GContext* ctx, uint32_t iteration) {
+    s_sink += plot_draw_u8_filled_line(ctx, &s_day_plot,
+                                       g_scene_day_precip_array,
+                                       SCENE_DAY_SAMPLES,
+                                       bench_day_offset(iteration),
+                                       SCENE_DAY_UNKNOWN, 0, true,
+                                       GColorCyan);
+}
+
+static void run_bpm_filled_line(GContext* ctx, uint32_t iteration) {
+    (void)iteration;
+    s_sink += plot_draw_filled_line(ctx, &s_bpm_plot, g_scene_bpm_values,
+                                    SCENE_BPM_SAMPLES, GColorRed);
+}
+
+static void run_bpm_day_min_max_line(GContext* ctx, uint32_t iteration) {
+    (void)iteration;
+    s_sink += plot_draw_min_max_line(ctx, &s_bpm_plot, g_scene_bpm_day_values,
+                                     SCENE_BPM_DAY_SAMPLES, SCENE_BPM_MISSING,
+                                     GColorRed);
+}
+
+static void run_bpm_day_min_max_filled_line(GContext* ctx, uint32_t iteration) {
+    (void)iteration;
+    s_sink += plot_draw_min_max_filled_line(ctx, &s_bpm_plot,
+                                            g_scene_bpm_day_values,
+                                            SCENE_BPM_DAY_SAMPLES,
+                                            SCENE_BPM_MISSING, GColorRed);
+}
+
+static void run_day_atemp_line(GContext* ctx, uint32_t iteration) {
+    s_sink += plot_draw_u8_line(ctx, &s_day_plot, g_scene_day_atemp_array,
+                                SCENE_DAY_SAMPLES, bench_day_offset(iteration),
+                                SCENE_DAY_UNKNOWN, -100, GColorRed);
+}
+
+static void run_day_atemp_y_range(GContext* ctx, uint32_t iteration) {
+    (void)ctx;
+    PlotLayout plot = s_day_plot;
+    s_sink += plot_set_y_range_from_u8(&plot, g_scene_day_atemp_array,
+                                       SCENE_DAY_SAMPLES,
+                                       bench_day_offset(iteration),
+                                       SCENE_DAY_UNKNOWN, -100);
+}
+
+static void run_dashed_horizontal_line(GContext* ctx, uint32_t iteration) {
+    (void)iteration;
+    plot_draw_horizontal_line(ctx, &s_day_plot, 50, GColorDarkGray, 2, 2);
+}
+
+static void run_dashed_vertical_lines(GContext* ctx, uint32_t iteration) {
+    static const int16_t grid_lines[] = {12, 24, 36};
+    (void)iteration;
+    plot_draw_vertical_lines(ctx, &s_day_plot, grid_lines,
+                             ARRAY_LENGTH(grid_lines), GColorDarkGray, 1, 2);
+}
+
+static void run_bpm_graph(GContext* ctx, uint32_t iteration) {
+    (void)iteration;
+    scene_draw_bpm_graph(ctx);
+}
+
+static void run_precip_graph(GContext* ctx, uint32_t iteration) {
+    scene_draw_precip_graph(ctx, bench_precip_offset(iteration));
+}
+
+static void run_day_graph(GContext* ctx, uint32_t iteration) {
+    scene_draw_day_graph(ctx, bench_day_offset(iteration));
+}
+
+static void run_heart_chrome(GContext* ctx, uint32_t iteration) {
+    (void)iteration;
+    chrome_scene_draw_heart(ctx);
+}
+
+static void run_day_graph_chrome(GContext* ctx, uint32_t iteration) {
+    chrome_scene_draw_day_graph(ctx, bench_day_offset(iteration));
+}
+
+static void run_precip_filled_line_framebuffer(GContext* ctx,
+                                              uint32_t iteration) {
+    s_sink += plot_draw_u8_filled_line(ctx, &s_precip_plot_framebuffer,
+                                       g_scene_precip_array,
+                                       SCENE_PRECIP_SAMPLES,
+                                       bench_precip_offset(iteration),
+                                       0, 0, true, GColorCyan);
+}
+
+static void run_day_precip_filled_line_framebuffer(GContext* ctx,
+                                                   uint32_t iteration) {
+    s_sink += plot_draw_u8_filled_line(ctx, &s_day_plot_framebuffer,
+                                       g_scene_day_precip_array,
+                                       SCENE_DAY_SAMPLES,
+                                       bench_day_offset(iteration),
+                                       SCENE_DAY_UNKNOWN, 0, true,
+                                       GColorCyan);
+}
+
+static void run_bpm_filled_line_framebuffer(GContext* ctx, uint32_t iteration) {
+    (void)iteration;
+    s_sink += plot_draw_filled_line(ctx, &s_bpm_plot_framebuffer,
+                                    g_scene_bpm_values, SCENE_BPM_SAMPLES,
+                                    GColorRed);
+}
+
+static void run_bpm_day_min_max_filled_line_framebuffer(GContext* ctx,
+                                                        uint32_t iteration) {
+    (void)iteration;
+    s_sink += plot_draw_min_max_filled_line(ctx, &s_bpm_plot_framebuffer,
+                                            g_scene_bpm_day_values,
+                                            SCENE_BPM_DAY_SAMPLES,
+                                            SCENE_BPM_MISSING, GColorRed);
+}
+
+static const BenchCase s_cases[] = {
+    {"plot_draw_u8_filled_line (precip)", run_precip_filled_line, false},
+    {"plot_draw_u8_filled_line (day precip)", run_day_precip_filled_line, false},
+    {"plot_draw_filled_line (bpm)", run_bpm_filled_line, false},
+    {"plot_draw_min_max_line (24 h bpm)", run_bpm_day_min_max_line, false},
+    {"plot_draw_min_max_filled_line (24 h bpm)", run_bpm_day_min_max_filled_line, false},
+    {"plot_draw_u8_line (day atemp)", run_day_atemp_line, false},
+    {"plot_set_y_range_from_u8 (day atemp)", run_day_atemp_y_range, false},
+    {"plot_draw_horizontal_line (dashed)", run_dashed_horizontal_line, false},
+    {"plot_draw_vertical_lines (dashed)", run_dashed_vertical_lines, false},
+    {"bpm graph", run_bpm_graph, false},
+    {"precip graph", run_precip_graph, false},
+    {"day graph", run_day_graph, false},
+    {"heart glyph (chrome)", run_heart_chrome, false},
+    {"day graph (chrome)", run_day_graph_chrome, false},
+    {"raster: u8 filled (precip) fill_rect", run_precip_filled_line, true},
+    {"raster: u8 filled (precip) framebuffer", run_precip_filled_line_framebuffer, true},
+    {"raster: u8 filled (day) fill_rect", run_day_precip_filled_line, true},
+    {"raster: u8 filled (day) framebuffer", run_day_precip_filled_line_framebuffer, true},
+    {"raster: filled (bpm) fill_rect", run_bpm_filled_line, true},
+    {"raster: filled (bpm) framebuffer", run_bpm_filled_line_framebuffer, true},
+    {"raster: min/max filled (24 h) fill_rect", run_bpm_day_min_max_filled_line, true},
+    {"raster: min/max filled (24 h) framebuffer", run_bpm_day_min_max_filled_line_framebuffer, true},
+};
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = BENCH_DEFAULT_ITERATIONS;
+    if (argc > 1) {
+        iterations = (uint32_t)strtoul(argv[1], NULL, 10);
+        if (iterations == 0) { iterations = 1; }
+    }
+
+    static GContext ctx;
+    scene_fill_sample_data();
+    chrome_scenes_init();
+    s_precip_plot = plot_layout(GRect(0, 0, 49, 27), 2, 1, 2, 1, 0, 240);
+    s_day_plot = plot_layout(GRect(0, 0, SCENE_DAY_SAMPLES+2, 27),
+                             1, 1, 1, 1, 0, 100);
+    s_bpm_plot = plot_layout(GRect(0, 0, 34, 22), 2, 1, 2, 1, 50, 145);
+    s_precip_plot_framebuffer = s_precip_plot;
+    plot_use_framebuffer(&s_precip_plot_framebuffer, GRect(0, 0, 49, 27));
+    s_day_plot_framebuffer = s_day_plot;
+    plot_use_framebuffer(&s_day_plot_framebuffer,
+                         GRect(0, 0, SCENE_DAY_SAMPLES+2, 27));
+    s_bpm_plot_framebuffer = s_bpm_plot;
+    plot_use_framebuffer(&s_bpm_plot_framebuffer, GRect(0, 0, 34, 22));
+
+    printf("%-42s %10s %10s %10s %10s\n", "case", "ns/op", "calls/op",
+           "fill_rect", "draw_line");
+    for (size_t c=0; c<ARRAY_LENGTH(s_cases); c++) {
+        mock_graphics_reset(&ctx);
+        ctx.rasterize = s_cases[c].rasterize;
+        uint64_t start = bench_now_ns();
+        for (uint32_t i=0; i<iterations; i++) {
+            s_cases[c].run(&ctx, i);
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        printf("%-42s %10.1f %10.2f %10.2f %10.2f\n", s_cases[c].name,
+               (double)elapsed/iterations,
+               (double)mock_graphics_draw_calls(&ctx)/iterations,
+               (double)ctx.counts.fill_rect/iterations,
+               (double)ctx.counts.draw_line/iterations);
+    }
+    return 0;
+}
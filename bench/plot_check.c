@@ -0,0 +1,420 @@
+// Pixel-equivalence checks for src/c/plot.c.  Every scene is rendered once
+// through the current plotter and once through the frozen reference copy in
+// reference/plot.c; any framebuffer difference is a failure.
+
+#include <stdio.h>
+
+#include "plot.h"
+#include "plot_scenes.h"
+
+void ref_scene_draw_bpm_graph(GContext* ctx);
+void ref_scene_draw_precip_graph(GContext* ctx, uint16_t minute_offset);
+void ref_scene_draw_day_graph(GContext* ctx, uint16_t half_hour_offset);
+void ref_scene_draw_series(GContext* ctx, const SceneSeries* series);
+
+#define CHECK_SERIES_LENGTH 96
+#define CHECK_DECIMATED_LENGTH 1500
+
+static GContext s_actual;
+static GContext s_expected;
+static uint32_t s_checks;
+static uint32_t s_failures;
+static uint32_t s_random_state = 12345;
+
+static uint32_t check_random(void) {
+    s_random_state = s_random_state*1103515245u + 12345u;
+    return s_random_state >> 8;
+}
+
+static void check_frames(const char* name, int variant) {
+    s_checks += 1;
+    if (mock_graphics_equal(&s_actual, &s_expected)) { return; }
+    s_failures += 1;
+    if (s_failures <= 10) {
+        printf("FAIL %s (%d): pixels differ\n", name, variant);
+    }
+}
+
+static void check_scenes(void) {
+    mock_graphics_reset(&s_actual);
+    mock_graphics_reset(&s_expected);
+    scene_draw_bpm_graph(&s_actual);
+    ref_scene_draw_bpm_graph(&s_expected);
+    check_frames("bpm graph", 0);
+
+    for (uint16_t offset=0; offset<=SCENE_PRECIP_SAMPLES; offset++) {
+        mock_graphics_reset(&s_actual);
+        mock_graphics_reset(&s_expected);
+        scene_draw_precip_graph(&s_actual, offset);
+        ref_scene_draw_precip_graph(&s_expected, offset);
+        check_frames("precip graph", offset);
+    }
+
+    for (uint16_t offset=0; offset<=SCENE_DAY_SAMPLES; offset++) {
+        mock_graphics_reset(&s_actual);
+        mock_graphics_reset(&s_expected);
+        scene_draw_day_graph(&s_actual, offset);
+        ref_scene_draw_day_graph(&s_expected, offset);
+        check_frames("day graph", offset);
+    }
+}
+
+static void check_watchface_frames(void) {
+    // The bpm, minute precip and day graph frames, swept over every value
+    // range up to a full byte and every sample count that range implies, so
+    // each x and y mapping the watchface can hit is compared.
+    static const GRect frames[] = {
+        {{0, 0}, {34, 22}}, {{0, 0}, {49, 27}}, {{0, 0}, {50, 27}}
+    };
+    static const int16_t margins[][4] = {
+        {2, 1, 2, 1}, {2, 1, 2, 1}, {1, 1, 1, 1}
+    };
+    static uint8_t u8_values[CHECK_SERIES_LENGTH];
+    static int16_t values[256];
+
+    for (size_t f=0; f<ARRAY_LENGTH(frames); f++) {
+        for (int16_t range=0; range<255; range++) {
+            int16_t y_min = -100 + range/3;
+            for (int16_t i=0; i<=range; i++) {
+                values[i] = y_min + i;
+            }
+            for (int i=0; i<CHECK_SERIES_LENGTH; i++) {
+                u8_values[i] = (uint8_t)((i*range)/CHECK_SERIES_LENGTH);
+            }
+            SceneSeries series = {
+                .frame = frames[f],
+                .left = margins[f][0], .top = margins[f][1],
+                .right = margins[f][2], .bottom = margins[f][3],
+                .y_min = y_min, .y_max = y_min + range,
+                .u8_values = u8_values,
+                .u8_length = CHECK_SERIES_LENGTH,
+                .decode_offset = y_min,
+                .missing_value = 255,
+                .values = values,
+                .count = (uint16_t)(range+1),
+            };
+            mock_graphics_reset(&s_actual);
+            mock_graphics_reset(&s_expected);
+            scene_draw_series(&s_actual, &series);
+            ref_scene_draw_series(&s_expected, &series);
+            check_frames("watchface frame", (int)(f*1000 + range));
+        }
+    }
+}
+
+static void fill_random_series(uint8_t* u8_values, int16_t* values,
+                               uint8_t missing_value) {
+    // Runs of constant values with occasional jumps and missing samples,
+    // which is what the watchface data looks like.
+    uint8_t current = (uint8_t)check_random();
+    for (int i=0; i<CHECK_SERIES_LENGTH; i++) {
+        uint32_t roll = check_random() % 16;
+        if (roll == 0) { current = (uint8_t)check_random(); }
+        else if (roll == 1) { current = 0; }
+        else if (roll == 2) { current += (uint8_t)(check_random() % 9) - 4; }
+        u8_values[i] = (check_random() % 20 == 0) ? missing_value : current;
+        values[i] = (int16_t)(current - 40);
+    }
+}
+
+static void check_random_series(void) {
+    static uint8_t u8_values[CHECK_SERIES_LENGTH];
+    static int16_t values[CHECK_SERIES_LENGTH];
+
+    for (int variant=0; variant<4000; variant++) {
+        SceneSeries series = {
+            .frame = GRect((int16_t)(check_random() % 8),
+                           (int16_t)(check_random() % 8),
+                           (int16_t)(2 + check_random() % 70),
+                           (int16_t)(2 + check_random() % 45)),
+            .left = (int16_t)(check_random() % 3),
+            .top = (int16_t)(check_random() % 3),
+            .right = (int16_t)(check_random() % 3),
+            .bottom = (int16_t)(check_random() % 3),
+            .y_min = (int16_t)(check_random() % 200) - 100,
+            .y_max = (int16_t)(check_random() % 300) - 50,
+            .u8_values = u8_values,
+            .u8_length = (uint16_t)(check_random() % CHECK_SERIES_LENGTH),
+            .start_index = (uint16_t)(check_random() % 64),
+            .missing_value = (check_random() % 2) ? 255 : 0,
+            .decode_offset = (check_random() % 2) ? -100 : 0,
+            .hide_zero = (check_random() % 2) != 0,
+            .values = values,
+            .count = (uint16_t)(check_random() % CHECK_SERIES_LENGTH),
+            .dash_length = (uint8_t)(check_random() % 4),
+            .gap_length = (uint8_t)(check_random() % 4),
+        };
+        fill_random_series(u8_values, values, series.missing_value);
+
+        mock_graphics_reset(&s_actual);
+        mock_graphics_reset(&s_expected);
+        scene_draw_series(&s_actual, &series);
+        ref_scene_draw_series(&s_expected, &series);
+        check_frames("random series", variant);
+    }
+}
+
+static void draw_heart_directly(GContext* ctx) {
+    graphics_context_set_fill_color(ctx, GColorRed);
+    graphics_fill_rect(ctx, GRect(1, 3, 2, 1), 0, GCornerNone);
+    graphics_fill_rect(ctx, GRect(5, 3, 2, 1), 0, GCornerNone);
+    graphics_fill_rect(ctx, GRect(0, 4, 8, 2), 0, GCornerNone);
+    graphics_fill_rect(ctx, GRect(1, 6, 6, 1), 0, GCornerNone);
+    graphics_fill_rect(ctx, GRect(2, 7, 4, 1), 0, GCornerNone);
+    graphics_fill_rect(ctx, GRect(3, 8, 2, 1), 0, GCornerNone);
+    graphics_fill_rect(ctx, GRect(4, 9, 1, 1), 0, GCornerNone);
+}
+
+// The chrome-cached day graph and heart glyph must match the reference
+// drawing, which draws its decoration directly, both from the bitmaps and
+// from the fallback path.
+static void check_chrome_scenes(bool fail_bitmaps) {
+    const char* name = fail_bitmaps ? "chrome fallback" : "chrome";
+    g_mock_graphics_fail_bitmaps = fail_bitmaps;
+    chrome_scenes_init();
+    g_mock_graphics_fail_bitmaps = false;
+
+    mock_graphics_reset(&s_actual);
+    mock_graphics_reset(&s_expected);
+    chrome_scene_draw_heart(&s_actual);
+    draw_heart_directly(&s_expected);
+    check_frames(name, 1);
+
+    for (uint16_t offset=0; offset<=SCENE_DAY_SAMPLES; offset++) {
+        mock_graphics_reset(&s_actual);
+        mock_graphics_reset(&s_expected);
+        chrome_scene_draw_day_graph(&s_actual, offset);
+        ref_scene_draw_day_graph(&s_expected, offset);
+        check_frames(name, 200 + offset);
+    }
+    chrome_scenes_deinit();
+}
+
+// Filled plots drawn through the captured framebuffer must match
+// graphics_fill_rect, including the clip to a layer smaller than the plot
+// and to the screen edges, and must release the framebuffer before anything
+// else draws.
+static void check_framebuffer_series(bool fail_capture) {
+    static uint8_t u8_values[CHECK_SERIES_LENGTH];
+    static int16_t values[CHECK_SERIES_LENGTH];
+    const char* name = fail_capture ? "framebuffer fallback" : "framebuffer";
+
+    g_mock_graphics_fail_capture = fail_capture;
+    for (int variant=0; variant<2000; variant++) {
+        GRect frame = GRect((int16_t)(check_random() % 8),
+                            (int16_t)(check_random() % 8),
+                            (int16_t)(2 + check_random() % 70),
+                            (int16_t)(2 + check_random() % 45));
+        // Origins from off the top-left to past the bottom-right, so the
+        // screen clips the layer on every side.
+        GRect layer = GRect((int16_t)(check_random() % 260) - 60,
+                            (int16_t)(check_random() % 300) - 60,
+                            frame.origin.x + frame.size.w,
+                            frame.origin.y + frame.size.h);
+        if (variant % 3 == 0) {
+            layer.size.w -= (int16_t)(check_random() % layer.size.w);
+            layer.size.h -= (int16_t)(check_random() % layer.size.h);
+        }
+        uint8_t missing_value = (check_random() % 2) ? 255 : 0;
+        fill_random_series(u8_values, values, missing_value);
+        uint16_t count = (uint16_t)(check_random() % CHECK_SERIES_LENGTH);
+        uint16_t start_index = (uint16_t)(check_random() % 32);
+        bool hide_zero = (check_random() % 2) != 0;
+        int16_t y_min = (int16_t)(check_random() % 200) - 100;
+        int16_t y_max = (int16_t)(check_random() % 300) - 50;
+
+        mock_graphics_reset(&s_actual);
+        mock_graphics_reset(&s_expected);
+        s_actual.origin = s_expected.origin = layer.origin;
+        s_actual.layer_size = s_expected.layer_size = layer.size;
+
+        PlotLayout plot = plot_layout(frame, 1, 1, 1, 1, y_min, y_max);
+        PlotLayout direct_plot = plot;
+        plot_use_framebuffer(&plot, layer);
+
+        plot_draw_filled_line(&s_actual, &plot, values, count, GColorRed);
+        plot_draw_u8_filled_line(&s_actual, &plot, u8_values,
+                                 CHECK_SERIES_LENGTH, start_index,
+                                 missing_value, -40, hide_zero, GColorCyan);
+        plot_draw_min_max_filled_line(&s_actual, &plot, values, count,
+                                      missing_value, GColorWhite);
+        plot_draw_filled_line(&s_expected, &direct_plot, values, count,
+                              GColorRed);
+        plot_draw_u8_filled_line(&s_expected, &direct_plot, u8_values,
+                                 CHECK_SERIES_LENGTH, start_index,
+                                 missing_value, -40, hide_zero, GColorCyan);
+        plot_draw_min_max_filled_line(&s_expected, &direct_plot, values,
+                                      count, missing_value, GColorWhite);
+
+        if (s_actual.counts.draws_while_captured != 0 ||
+            s_actual.framebuffer_captured) {
+            s_failures += 1;
+            printf("FAIL %s (%d): framebuffer misuse\n", name, variant);
+        }
+        if (!fail_capture && s_actual.counts.fill_rect != 0) {
+            s_failures += 1;
+            printf("FAIL %s (%d): fill_rect while captured\n", name, variant);
+        }
+        check_frames(name, variant);
+    }
+    g_mock_graphics_fail_capture = false;
+}
+
+// The decimating plotters have no counterpart in reference/plot.c, so they
+// are compared with a direct per-column implementation that divides for
+// every sample and every pixel.
+typedef struct {
+    GRect area;
+    int16_t y_min;
+    int16_t y_max;
+} NaivePlot;
+
+static NaivePlot naive_plot(const SceneSeries* series) {
+    NaivePlot plot = {
+        .area = GRect(series->frame.origin.x+series->left,
+                      series->frame.origin.y+series->top,
+                      series->frame.size.w-series->left-series->right,
+                      series->frame.size.h-series->top-series->bottom),
+        .y_min = series->y_min < series->y_max ? series->y_min : series->y_max,
+        .y_max = series->y_min < series->y_max ? series->y_max : series->y_min,
+    };
+    if (plot.area.size.w < 1) { plot.area.size.w = 1; }
+    if (plot.area.size.h < 1) { plot.area.size.h = 1; }
+    if (plot.y_min == plot.y_max) {
+        plot.y_min -= 1;
+        plot.y_max += 1;
+    }
+    return plot;
+}
+
+static int16_t naive_y(const NaivePlot* plot, int16_t value) {
+    if (value < plot->y_min) { value = plot->y_min; }
+    if (value > plot->y_max) { value = plot->y_max; }
+    int16_t bottom = plot->area.origin.y + plot->area.size.h - 1;
+    return bottom - (int16_t)(((int32_t)value-plot->y_min) *
+                              (plot->area.size.h-1) /
+                              ((int32_t)plot->y_max-plot->y_min));
+}
+
+static void naive_draw_min_max(GContext* ctx, const SceneSeries* series,
+                               int16_t missing_value, bool filled) {
+    NaivePlot plot = naive_plot(series);
+    int16_t w = plot.area.size.w;
+    uint16_t count = series->count;
+    bool decimates = count > w;
+    uint16_t columns = decimates ? (uint16_t)w : count;
+    int16_t baseline = naive_y(&plot, plot.y_min);
+    int16_t last_x = 0, last_top = 0, last_bottom = 0;
+    bool has_last = false;
+
+    graphics_context_set_stroke_color(ctx, GColorRed);
+    graphics_context_set_fill_color(ctx, GColorRed);
+    for (uint16_t c=0; c<columns; c++) {
+        int16_t low = 0, high = 0;
+        bool has_value = false;
+        for (uint16_t i=0; i<count; i++) {
+            uint16_t column = decimates ? (uint16_t)((uint32_t)i*w/count) : i;
+            int16_t value = series->values[i];
+            if (column != c || value == missing_value) { continue; }
+            if (!has_value || value < low) { low = value; }
+            if (!has_value || value > high) { high = value; }
+            has_value = true;
+        }
+        int16_t x = plot.area.origin.x;
+        if (decimates) {
+            x += c;
+        } else if (count > 1 && w > 1) {
+            x += (int16_t)((int32_t)c*(w-1)/(count-1));
+        }
+        if (!has_value) {
+            has_last = false;
+            continue;
+        }
+
+        int16_t top = naive_y(&plot, high);
+        int16_t bottom = naive_y(&plot, low);
+        if (filled) {
+            graphics_fill_rect(ctx, GRect(x, top, 1, baseline-top+1), 0,
+                               GCornerNone);
+        } else if (!decimates) {
+            graphics_draw_line(ctx, GPoint(has_last ? last_x : x,
+                                           has_last ? last_top : top),
+                               GPoint(x, top));
+        } else {
+            int16_t from = has_last && top > last_bottom ? last_bottom : top;
+            int16_t to = has_last && bottom < last_top ? last_top : bottom;
+            graphics_draw_line(ctx, GPoint(x, from), GPoint(x, to));
+        }
+        last_x = x;
+        last_top = top;
+        last_bottom = bottom;
+        has_last = true;
+    }
+}
+
+static void check_min_max_series(void) {
+    static int16_t values[CHECK_DECIMATED_LENGTH];
+    const int16_t missing_value = -1;
+
+    for (int variant=0; variant<2000; variant++) {
+        // Noisy heart-rate-like data with spikes, dips and gaps.
+        int16_t current = (int16_t)(50 + check_random() % 60);
+        for (int i=0; i<CHECK_DECIMATED_LENGTH; i++) {
+            uint32_t roll = check_random() % 64;
+            if (roll == 0) { values[i] = (int16_t)(check_random() % 220); }
+            else if (roll == 1) { values[i] = missing_value; }
+            else {
+                current += (int16_t)(check_random() % 5) - 2;
+                values[i] = current;
+            }
+        }
+
+        SceneSeries series = {
+            .frame = GRect((int16_t)(check_random() % 8),
+                           (int16_t)(check_random() % 8),
+                           (int16_t)(2 + check_random() % 70),
+                           (int16_t)(2 + check_random() % 45)),
+            .left = (int16_t)(check_random() % 3),
+            .top = (int16_t)(check_random() % 3),
+            .right = (int16_t)(check_random() % 3),
+            .bottom = (int16_t)(check_random() % 3),
+            .y_min = (int16_t)(check_random() % 100),
+            .y_max = (int16_t)(check_random() % 250),
+            .values = values,
+            .count = (uint16_t)(variant % 4 == 0 ?
+                                check_random() % 80 :
+                                check_random() % CHECK_DECIMATED_LENGTH),
+        };
+        PlotLayout plot = plot_layout(series.frame, series.left, series.top,
+                                      series.right, series.bottom,
+                                      series.y_min, series.y_max);
+
+        mock_graphics_reset(&s_actual);
+        mock_graphics_reset(&s_expected);
+        plot_draw_min_max_line(&s_actual, &plot, values, series.count,
+                               missing_value, GColorRed);
+        naive_draw_min_max(&s_expected, &series, missing_value, false);
+        check_frames("min/max line", variant);
+
+        mock_graphics_reset(&s_actual);
+        mock_graphics_reset(&s_expected);
+        plot_draw_min_max_filled_line(&s_actual, &plot, values, series.count,
+                                      missing_value, GColorRed);
+        naive_draw_min_max(&s_expected, &series, missing_value, true);
+        check_frames("min/max filled line", variant);
+    }
+}
+
+int main(void) {
+    scene_fill_sample_data();
+    check_scenes();
+    check_watchface_frames();
+    check_random_series();
+    check_min_max_series();
+    check_chrome_scenes(false);
+    check_chrome_scenes(true);
+    check_framebuffer_series(false);
+    check_framebuffer_series(true);
+    printf("%u checks, %u failures\n", s_checks, s_failures);
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "plot_scenes.h"
+#include "plot.h"
+
+void scene_draw_bpm_graph(GContext* ctx) {
+    PlotLayout plot = plot_layout(GRect(0, 0, 34, 22), 2, 1, 2, 1, 50, 145);
+    plot_draw_horizontal_line(ctx, &plot, 95, GColorDarkGray, 0, 0);
+    plot_draw_filled_line(ctx, &plot, g_scene_bpm_values,
+                          ARRAY_LENGTH(g_scene_bpm_values), GColorRed);
+    plot_draw_frame(ctx, &plot, GColorWhite);
+    plot_draw_vertical_line(ctx, &plot, 14, GColorDarkGray, 0, 0);
+}
+
+void scene_draw_precip_graph(GContext* ctx, uint16_t minute_offset) {
+    static const int16_t grid_lines[] = {15, 30};
+    PlotLayout plot = plot_layout(GRect(0, 0, 49, 27), 2, 1, 2, 1, 0, 240);
+
+    uint16_t drawn = plot_draw_u8_filled_line(
+        ctx, &plot, g_scene_precip_array, SCENE_PRECIP_SAMPLES,
+        minute_offset, 0, 0, true, GColorCyan);
+    if (drawn == 0) {
+        return;
+    }
+
+    plot_draw_frame(ctx, &plot, GColorWhite);
+    plot_draw_vertical_lines(ctx, &plot, grid_lines, ARRAY_LENGTH(grid_lines),
+                             GColorDarkGray, 0, 0);
+    if (minute_offset > 15) {
+        uint16_t first_missing = plot_visible_u8_count(
+            &plot, SCENE_PRECIP_SAMPLES, minute_offset);
+        plot_fill_tail(ctx, &plot, first_missing, plot.area.size.w, 2,
+                       GColorDarkGray);
+    }
+}
+
+void scene_draw_day_graph(GContext* ctx, uint16_t half_hour_offset) {
+    static const int16_t grid_lines[] = {12, 24, 36};
+    PlotLayout plot = plot_layout(GRect(0, 0, SCENE_DAY_SAMPLES+2, 27),
+                                  1, 1, 1, 1, 0, 100);
+    bool has_temp = plot_has_u8_values(&plot, g_scene_day_atemp_array,
+                                       SCENE_DAY_SAMPLES, half_hour_offset,
+                                       SCENE_DAY_UNKNOWN);
+    bool has_precip = plot_has_u8_values(&plot, g_scene_day_precip_array,
+                                         SCENE_DAY_SAMPLES, half_hour_offset,
+                                         SCENE_DAY_UNKNOWN);
+    if (!has_temp && !has_precip) {
+        return;
+    }
+
+    plot_draw_frame(ctx, &plot, GColorWhite);
+    plot_draw_vertical_lines(ctx, &plot, grid_lines, ARRAY_LENGTH(grid_lines),
+                             GColorDarkGray, 0, 0);
+    if (has_precip) {
+        plot_set_y_range(&plot, 0, 100);
+        plot_draw_u8_filled_line(ctx, &plot, g_scene_day_precip_array,
+                                 SCENE_DAY_SAMPLES, half_hour_offset,
+                                 SCENE_DAY_UNKNOWN, 0, true, GColorCyan);
+        plot_draw_vertical_lines(ctx, &plot, grid_lines, ARRAY_LENGTH(grid_lines),
+                                 GColorDarkGray, 0, 0);
+    }
+    if (has_temp) {
+        plot_set_y_range_from_u8(&plot, g_scene_day_atemp_array,
+                                 SCENE_DAY_SAMPLES, half_hour_offset,
+                                 SCENE_DAY_UNKNOWN, -100);
+        plot_draw_u8_line(ctx, &plot, g_scene_day_atemp_array,
+                          SCENE_DAY_SAMPLES, half_hour_offset,
+                          SCENE_DAY_UNKNOWN, -100, GColorRed);
+    }
+    plot_draw_frame(ctx, &plot, GColorWhite);
+}
+
+void scene_draw_series(GContext* ctx, const SceneSeries* series) {
+    static const int16_t grid_lines[] = {-1, 0, 7, 15, 30, 200};
+    PlotLayout plot = plot_layout(series->frame, series->left, series->top,
+                                  series->right, series->bottom,
+                                  series->y_min, series->y_max);
+    plot_draw_horizontal_line(ctx, &plot, (series->y_min+series->y_max)/2,
+                              GColorDarkGray, series->dash_length,
+                              series->gap_length);
+    plot_draw_vertical_lines(ctx, &plot, grid_lines, ARRAY_LENGTH(grid_lines),
+                             GColorDarkGray, series->dash_length,
+                             series->gap_length);
+    plot_draw_filled_line(ctx, &plot, series->values, series->count,
+                          GColorRed);
+    plot_draw_u8_filled_line(ctx, &plot, series->u8_values, series->u8_length,
+                             series->start_index, series->missing_value,
+                             series->decode_offset, series->hide_zero,
+                             GColorCyan);
+    if (plot_set_y_range_from_u8(&plot, series->u8_values, series->u8_length,
+                                 series->start_index, series->missing_value,
+                                 series->decode_offset)) {
+        plot_draw_u8_line(ctx, &plot, series->u8_values, series->u8_length,
+                          series->start_index, series->missing_value,
+                          series->decode_offset, GColorWhite);
+    }
+    plot_fill_tail(ctx, &plot,
+                   plot_visible_u8_count(&plot, series->u8_length,
+                                         series->start_index),
+                   plot.area.size.w, 2, GColorDarkGray);
+    plot_draw_frame(ctx, &plot, GColorWhite);
+}
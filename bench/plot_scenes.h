@@ -0,0 +1,52 @@
+#pragma once
+
+#include "mock_graphics.h"
+
+// Sample series shaped like the watchface globals they stand in for.
+#define SCENE_PRECIP_SAMPLES 60
+#define SCENE_DAY_SAMPLES 48
+#define SCENE_DAY_UNKNOWN 255
+#define SCENE_BPM_SAMPLES 30
+#define SCENE_BPM_DAY_SAMPLES 1440
+#define SCENE_BPM_MISSING (-1)
+
+extern uint8_t g_scene_precip_array[SCENE_PRECIP_SAMPLES];
+extern uint8_t g_scene_day_atemp_array[SCENE_DAY_SAMPLES];
+extern uint8_t g_scene_day_precip_array[SCENE_DAY_SAMPLES];
+extern int16_t g_scene_bpm_values[SCENE_BPM_SAMPLES];
+extern int16_t g_scene_bpm_day_values[SCENE_BPM_DAY_SAMPLES];
+
+// A free-form plot configuration used to sweep frame sizes and data shapes.
+typedef struct {
+    GRect frame;
+    int16_t left, top, right, bottom;
+    int16_t y_min, y_max;
+    const uint8_t* u8_values;
+    uint16_t u8_length;
+    uint16_t start_index;
+    uint8_t missing_value;
+    int16_t decode_offset;
+    bool hide_zero;
+    const int16_t* values;
+    uint16_t count;
+    uint8_t dash_length;
+    uint8_t gap_length;
+} SceneSeries;
+
+void scene_fill_sample_data(void);
+
+// Replicas of the watchface graph update procs, drawn into layer-local
+// bounds.  The offset arguments stand in for time_series_offset().
+void scene_draw_bpm_graph(GContext* ctx);
+void scene_draw_precip_graph(GContext* ctx, uint16_t minute_offset);
+void scene_draw_day_graph(GContext* ctx, uint16_t half_hour_offset);
+void scene_draw_series(GContext* ctx, const SceneSeries* series);
+
+// The day graph with its frame and grid cached by PlotChrome
+// (chrome_scenes.c), plus the heart glyph.  chrome_scenes_init renders the
+// chrome; with g_mock_graphics_fail_bitmaps set it exercises the direct
+// drawing fallback instead.
+void chrome_scenes_init(void);
+void chrome_scenes_deinit(void);
+void chrome_scene_draw_heart(GContext* ctx);
+void chrome_scene_draw_day_graph(GContext* ctx, uint16_t half_hour_offset);
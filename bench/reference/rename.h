@@ -0,0 +1,22 @@
+#pragma once
+
+// Renames the frozen reference plotter and the scenes built on it so they can
+// be linked next to the current src/c/plot.c in plot_check.
+
+#define plot_draw_filled_line ref_plot_draw_filled_line
+#define plot_draw_frame ref_plot_draw_frame
+#define plot_draw_horizontal_line ref_plot_draw_horizontal_line
+#define plot_draw_u8_filled_line ref_plot_draw_u8_filled_line
+#define plot_draw_u8_line ref_plot_draw_u8_line
+#define plot_draw_vertical_line ref_plot_draw_vertical_line
+#define plot_draw_vertical_lines ref_plot_draw_vertical_lines
+#define plot_fill_tail ref_plot_fill_tail
+#define plot_has_u8_values ref_plot_has_u8_values
+#define plot_layout ref_plot_layout
+#define plot_set_y_range ref_plot_set_y_range
+#define plot_set_y_range_from_u8 ref_plot_set_y_range_from_u8
+#define plot_visible_u8_count ref_plot_visible_u8_count
+#define scene_draw_bpm_graph ref_scene_draw_bpm_graph
+#define scene_draw_precip_graph ref_scene_draw_precip_graph
+#define scene_draw_day_graph ref_scene_draw_day_graph
+#define scene_draw_series ref_scene_draw_series
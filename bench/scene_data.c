@@ -0,0 +1,61 @@
+#include "plot_scenes.h"
+
+uint8_t g_scene_precip_array[SCENE_PRECIP_SAMPLES];
+uint8_t g_scene_day_atemp_array[SCENE_DAY_SAMPLES];
+uint8_t g_scene_day_precip_array[SCENE_DAY_SAMPLES];
+int16_t g_scene_bpm_values[SCENE_BPM_SAMPLES];
+int16_t g_scene_bpm_day_values[SCENE_BPM_DAY_SAMPLES];
+
+void scene_fill_sample_data(void) {
+    // Minute precipitation: dry for a while, then a shower that ramps up,
+    // plateaus and tails off, encoded the same way as index.js (mm/h*25.5).
+    for (int i=0; i<SCENE_PRECIP_SAMPLES; i++) {
+        uint8_t value = 0;
+        if (i >= 18 && i < 26) { value = (uint8_t)((i-17)*12); }
+        else if (i >= 26 && i < 40) { value = 96; }
+        else if (i >= 40 && i < 48) { value = (uint8_t)((48-i)*11); }
+        g_scene_precip_array[i] = value;
+    }
+
+    // Half-hourly apparent temperature (Celsius + 100) over a day: a smooth
+    // rise and fall with two missing samples, like a partial hourly feed.
+    static const int8_t temps[SCENE_DAY_SAMPLES] = {
+        4, 4, 3, 3, 2, 2, 1, 1, 1, 2, 3, 4, 6, 8, 10, 11,
+        12, 13, 14, 14, 15, 15, 15, 14, 13, 12, 11, 10, 9, 8, 7, 7,
+        6, 6, 5, 5, 5, 4, 4, 4, 3, 3, 3, 2, 2, 2, 1, 1
+    };
+    for (int i=0; i<SCENE_DAY_SAMPLES; i++) {
+        g_scene_day_atemp_array[i] = (uint8_t)(temps[i]+100);
+    }
+    g_scene_day_atemp_array[SCENE_DAY_SAMPLES-2] = SCENE_DAY_UNKNOWN;
+    g_scene_day_atemp_array[SCENE_DAY_SAMPLES-1] = SCENE_DAY_UNKNOWN;
+
+    // Half-hourly precipitation probability: long flat stretches.
+    for (int i=0; i<SCENE_DAY_SAMPLES; i++) {
+        uint8_t value = 0;
+        if (i >= 10 && i < 20) { value = 20; }
+        else if (i >= 20 && i < 28) { value = 65; }
+        else if (i >= 28 && i < 32) { value = 40; }
+        g_scene_day_precip_array[i] = value;
+    }
+
+    // Heart rate: flat-lined last_bpm with a short bump, as produced by the
+    // carry-forward in on_health_bpm_graph_layer_update.
+    for (int i=0; i<SCENE_BPM_SAMPLES; i++) {
+        int16_t value = 62;
+        if (i >= 12 && i < 16) { value = 88; }
+        else if (i >= 16 && i < 19) { value = 74; }
+        g_scene_bpm_values[i] = value;
+    }
+
+    // A day of per-minute heart rate: a low night, a busier day with a
+    // couple of one-minute spikes, and gaps where the sensor lost contact.
+    for (int i=0; i<SCENE_BPM_DAY_SAMPLES; i++) {
+        int16_t value = (i < 7*60 || i >= 23*60) ? 52 : 68;
+        value += (int16_t)((i*7) % 11) - 5;
+        if (i >= 18*60 && i < 18*60+40) { value = 132; }
+        if (i == 9*60+13 || i == 15*60+2) { value = 158; }
+        if (i >= 3*60 && i < 3*60+25) { value = SCENE_BPM_MISSING; }
+        g_scene_bpm_day_values[i] = value;
+    }
+}
@@ -1,4 +1,5 @@
 #include "plot.h"
+#include "profile.h"
 
 static int16_t plot_min_i16(int16_t a, int16_t b) { return a < b ? a : b; }
 static int16_t plot_max_i16(int16_t a, int16_t b) { return a > b ? a : b; }
@@ -17,16 +18,124 @@ static int16_t plot_x_for_index(const PlotLayout* layout, uint16_t index,
         ((int32_t)index * (layout->area.size.w-1)) / (count-1);
 }
 
+// Steps through the x positions of index 0, 1, 2, ... of a count-sample
+// series without a division per sample.  Produces the same pixels as
+// plot_x_for_index.
+typedef struct {
+    int16_t x;
+    uint16_t remainder;
+    uint16_t step;
+    uint16_t step_remainder;
+    uint16_t divisor;
+} PlotXStepper;
+
+static void plot_x_stepper_init(PlotXStepper* stepper,
+                                const PlotLayout* layout, uint16_t count) {
+    stepper->x = layout->area.origin.x;
+    stepper->remainder = 0;
+    if (count <= 1 || layout->area.size.w <= 1) {
+        stepper->step = 0;
+        stepper->step_remainder = 0;
+        stepper->divisor = 1;
+        return;
+    }
+    stepper->divisor = count-1;
+    stepper->step = (layout->area.size.w-1) / stepper->divisor;
+    stepper->step_remainder = (layout->area.size.w-1) % stepper->divisor;
+}
+
+static void plot_x_stepper_next(PlotXStepper* stepper) {
+    stepper->x += stepper->step;
+    stepper->remainder += stepper->step_remainder;
+    if (stepper->remainder >= stepper->divisor) {
+        stepper->remainder -= stepper->divisor;
+        stepper->x += 1;
+    }
+}
+
+// Walks a series one plot column at a time.  With more samples than columns
+// column c covers samples [ceil(c*count/w), ceil((c+1)*count/w)) and reports
+// their min and max, found in a single pass without a division per sample.
+// Every column gets at least one sample since count > w.  With no
+// more samples than columns every sample is its own column, placed like
+// plot_x_for_index.
+typedef struct {
+    const int16_t* values;
+    int16_t missing_value;
+    uint16_t index;
+    uint16_t count;
+    uint16_t columns;
+    uint32_t remainder;
+    int16_t x;
+    PlotXStepper stepper;
+} PlotDecimator;
+
+static void plot_decimator_init(PlotDecimator* decimator,
+                                const PlotLayout* layout,
+                                const int16_t* values, uint16_t count,
+                                int16_t missing_value) {
+    decimator->values = values;
+    decimator->missing_value = missing_value;
+    decimator->index = 0;
+    decimator->count = count;
+    decimator->columns = layout->area.size.w;
+    decimator->remainder = 0;
+    decimator->x = layout->area.origin.x;
+    plot_x_stepper_init(&decimator->stepper, layout, count);
+}
+
+static bool plot_decimator_decimates(const PlotDecimator* decimator) {
+    return decimator->count > decimator->columns;
+}
+
+// Returns false once the series is exhausted.  *has_value is false for a
+// column whose samples are all missing.
+static bool plot_decimator_next(PlotDecimator* decimator, int16_t* x,
+                                int16_t* low, int16_t* high,
+                                bool* has_value) {
+    if (decimator->index >= decimator->count) { return false; }
+    *has_value = false;
+
+    if (!plot_decimator_decimates(decimator)) {
+        int16_t value = decimator->values[decimator->index++];
+        *x = decimator->stepper.x;
+        plot_x_stepper_next(&decimator->stepper);
+        if (value == decimator->missing_value) { return true; }
+        *low = value;
+        *high = value;
+        *has_value = true;
+        return true;
+    }
+
+    *x = decimator->x++;
+    while (decimator->index < decimator->count) {
+        int16_t value = decimator->values[decimator->index++];
+        if (value != decimator->missing_value) {
+            if (!*has_value) {
+                *low = value;
+                *high = value;
+                *has_value = true;
+            } else {
+                *low = plot_min_i16(*low, value);
+                *high = plot_max_i16(*high, value);
+            }
+        }
+        decimator->remainder += decimator->columns;
+        if (decimator->remainder >= decimator->count) {
+            decimator->remainder -= decimator->count;
+            break;
+        }
+    }
+    return true;
+}
+
 static int16_t plot_y_for_value(const PlotLayout* layout, int16_t value) {
     int16_t clipped = plot_min_i16(layout->y_max,
                                    plot_max_i16(layout->y_min, value));
     int16_t bottom = layout->area.origin.y + layout->area.size.h - 1;
-    if (layout->area.size.h <= 1 || layout->y_min == layout->y_max) {
-        return bottom;
-    }
-    return bottom - ((int32_t)(clipped-layout->y_min) *
-                     (layout->area.size.h-1)) /
-                     (layout->y_max-layout->y_min);
+    uint32_t offset = (uint32_t)((int32_t)clipped-layout->y_min);
+    return bottom - (int16_t)(((uint64_t)offset*layout->y_scale) >>
+                              layout->y_shift);
 }
 
 static bool plot_read_u8(const uint8_t* values, uint16_t length,
@@ -41,14 +150,267 @@ static bool plot_read_u8(const uint8_t* values, uint16_t length,
     return true;
 }
 
-static void plot_fill_column(GContext* ctx, const PlotLayout* layout,
-                             uint16_t index, uint16_t count, int16_t value) {
-    int16_t baseline = plot_y_for_value(layout, layout->y_min);
+// Fills rect, clipped to the bitmap, in an 8-bit bitmap: an offscreen chrome
+// bitmap or the captured framebuffer.
+static void plot_bitmap_fill(GBitmap* bitmap, GRect rect, GColor color) {
+    GRect bounds = gbitmap_get_bounds(bitmap);
+    int16_t x1 = plot_max_i16(rect.origin.x, bounds.origin.x);
+    int16_t y1 = plot_max_i16(rect.origin.y, bounds.origin.y);
+    int16_t x2 = plot_min_i16(rect.origin.x + rect.size.w,
+                              bounds.origin.x + bounds.size.w) - 1;
+    int16_t y2 = plot_min_i16(rect.origin.y + rect.size.h,
+                              bounds.origin.y + bounds.size.h) - 1;
+    for (int16_t y=y1; y<=y2; y++) {
+        GBitmapDataRowInfo row = gbitmap_get_data_row_info(bitmap, y);
+        int16_t row_x1 = plot_max_i16(x1, row.min_x);
+        int16_t row_x2 = plot_min_i16(x2, row.max_x);
+        if (row_x1 <= row_x2) {
+            memset(row.data + row_x1, color.argb, row_x2-row_x1+1);
+        }
+    }
+}
+
+// Filled plots are drawn as runs of adjacent columns.  Neighbouring columns
+// with the same top share one rectangle, and when several segments of a run
+// sit at the run's lowest top the run is drawn as one body rectangle plus caps
+// for the taller segments.  The union of pixels is the same as one rectangle
+// per column.
+#define PLOT_RUN_SEGMENTS 16
+
+typedef struct {
+    int16_t x;
+    int16_t width;
+    int16_t top;
+} PlotSegment;
+
+typedef struct {
+    GContext* ctx;
+    GBitmap* framebuffer; // Captured for plot_use_framebuffer layouts.
+    GPoint origin;        // Layer origin on screen, when framebuffer is set.
+    GRect clip;           // Layer frame clipped to the framebuffer.
+    uint8_t* pixels;      // Framebuffer row 0, indexed by screen x.
+    uint16_t stride;      // Bytes from one framebuffer row to the next.
+    GColor color;
+    int16_t baseline;
+    uint8_t count;
+    PlotSegment segments[PLOT_RUN_SEGMENTS];
+} PlotColumnRun;
+
+static void plot_run_init(PlotColumnRun* run, GContext* ctx,
+                          const PlotLayout* layout, GColor color) {
+    run->ctx = ctx;
+    run->framebuffer = NULL;
+    run->origin = layout->screen_frame.origin;
+    run->clip = layout->screen_frame;
+    run->color = color;
+    run->baseline = plot_y_for_value(layout, layout->y_min);
+    run->count = 0;
+
+#ifndef PBL_ROUND
+    if (layout->use_framebuffer) {
+        run->framebuffer = graphics_capture_frame_buffer(ctx);
+        if (run->framebuffer &&
+            gbitmap_get_format(run->framebuffer) != GBitmapFormat8Bit) {
+            graphics_release_frame_buffer(ctx, run->framebuffer);
+            run->framebuffer = NULL;
+        }
+    }
+#endif
+    if (run->framebuffer) {
+        // Rectangular displays have the same span on every row, so one row
+        // lookup serves the whole run and rows are a fixed stride apart.
+        // Round displays do not, and keep graphics_fill_rect.
+        GRect bounds = gbitmap_get_bounds(run->framebuffer);
+        GBitmapDataRowInfo row = gbitmap_get_data_row_info(run->framebuffer,
+                                                           bounds.origin.y);
+        int16_t x1 = plot_max_i16(run->clip.origin.x, row.min_x);
+        int16_t y1 = plot_max_i16(run->clip.origin.y, bounds.origin.y);
+        int16_t x2 = plot_min_i16(run->clip.origin.x + run->clip.size.w - 1,
+                                  row.max_x);
+        int16_t y2 = plot_min_i16(run->clip.origin.y + run->clip.size.h,
+                                  bounds.origin.y + bounds.size.h) - 1;
+        run->clip = GRect(x1, y1, plot_max_i16(x2-x1+1, 0),
+                          plot_max_i16(y2-y1+1, 0));
+        run->stride = gbitmap_get_bytes_per_row(run->framebuffer);
+        run->pixels = row.data - bounds.origin.y*run->stride;
+    } else {
+        graphics_context_set_fill_color(ctx, color);
+    }
+}
+
+// rect is in layer coordinates, like the graphics_fill_rect it replaces.
+static void plot_run_fill_rect(PlotColumnRun* run, GRect rect) {
+    if (!run->framebuffer) {
+        graphics_fill_rect(run->ctx, rect, 0, GCornerNone);
+        return;
+    }
+    rect.origin.x += run->origin.x;
+    rect.origin.y += run->origin.y;
+    int16_t x1 = plot_max_i16(rect.origin.x, run->clip.origin.x);
+    int16_t x2 = plot_min_i16(rect.origin.x + rect.size.w,
+                              run->clip.origin.x + run->clip.size.w) - 1;
+    int16_t y1 = plot_max_i16(rect.origin.y, run->clip.origin.y);
+    int16_t y2 = plot_min_i16(rect.origin.y + rect.size.h,
+                              run->clip.origin.y + run->clip.size.h) - 1;
+    if (x1 > x2 || y1 > y2) { return; }
+
+    uint8_t* pixel = run->pixels + y1*run->stride + x1;
+    uint8_t argb = run->color.argb;
+    if (x1 == x2) {
+        // Most runs are single columns: one byte per row.
+        for (int16_t y=y1; y<=y2; y++, pixel+=run->stride) { *pixel = argb; }
+        return;
+    }
+    for (int16_t y=y1; y<=y2; y++, pixel+=run->stride) {
+        memset(pixel, argb, x2-x1+1);
+    }
+}
+
+static void plot_run_flush(PlotColumnRun* run) {
+    if (run->count == 0) { return; }
+
+    int16_t body_top = run->segments[0].top;
+    for (uint8_t i=1; i<run->count; i++) {
+        body_top = plot_max_i16(body_top, run->segments[i].top);
+    }
+    uint8_t body_segments = 0;
+    for (uint8_t i=0; i<run->count; i++) {
+        if (run->segments[i].top == body_top) { body_segments += 1; }
+    }
+
+    if (body_segments < 2) {
+        for (uint8_t i=0; i<run->count; i++) {
+            const PlotSegment* segment = &run->segments[i];
+            plot_run_fill_rect(run, GRect(segment->x, segment->top,
+                                          segment->width,
+                                          run->baseline-segment->top+1));
+        }
+    } else {
+        const PlotSegment* last = &run->segments[run->count-1];
+        int16_t x = run->segments[0].x;
+        plot_run_fill_rect(run, GRect(x, body_top,
+                                      last->x+last->width-x,
+                                      run->baseline-body_top+1));
+        for (uint8_t i=0; i<run->count; i++) {
+            const PlotSegment* segment = &run->segments[i];
+            if (segment->top == body_top) { continue; }
+            plot_run_fill_rect(run, GRect(segment->x, segment->top,
+                                          segment->width,
+                                          body_top-segment->top));
+        }
+    }
+    run->count = 0;
+}
+
+static void plot_run_finish(PlotColumnRun* run) {
+    plot_run_flush(run);
+    if (run->framebuffer) {
+        graphics_release_frame_buffer(run->ctx, run->framebuffer);
+        run->framebuffer = NULL;
+    }
+}
+
+static void plot_run_add(PlotColumnRun* run, const PlotLayout* layout,
+                         int16_t x, int16_t value) {
+    int16_t top = plot_min_i16(plot_y_for_value(layout, value), run->baseline);
+
+    if (run->count > 0) {
+        PlotSegment* last = &run->segments[run->count-1];
+        if (x != last->x+last->width) {
+            plot_run_flush(run);
+        } else if (top == last->top) {
+            last->width += 1;
+            return;
+        } else if (run->count == PLOT_RUN_SEGMENTS) {
+            plot_run_flush(run);
+        }
+    }
+    run->segments[run->count++] = (PlotSegment){
+        .x = x, .width = 1, .top = top
+    };
+}
+
+// Where the frame and grid primitives draw: the graphics context, or an
+// offscreen 8-bit bitmap holding cached chrome.  Only axis-aligned lines are
+// drawn, so the bitmap side needs nothing beyond filling rectangles.
+typedef struct {
+    GContext* ctx;
+    GBitmap* bitmap;
+} PlotTarget;
+
+static PlotTarget plot_chrome_target(const PlotChrome* chrome) {
+    if (chrome->ctx) { return (PlotTarget){.ctx = chrome->ctx}; }
+    return (PlotTarget){.bitmap = chrome->bitmap};
+}
+
+static void plot_target_set_stroke_color(const PlotTarget* target,
+                                         GColor color) {
+    if (target->ctx) { graphics_context_set_stroke_color(target->ctx, color); }
+}
+
+// p0 and p1 lie on one row or one column, p0 first.
+static void plot_target_line(const PlotTarget* target, GPoint p0, GPoint p1,
+                             GColor color) {
+    if (target->bitmap) {
+        plot_bitmap_fill(target->bitmap,
+                         GRect(p0.x, p0.y, p1.x-p0.x+1, p1.y-p0.y+1), color);
+        return;
+    }
+    graphics_draw_line(target->ctx, p0, p1);
+}
+
+static void plot_frame(const PlotTarget* target, const PlotLayout* layout,
+                       GColor color) {
+    if (target->ctx) {
+        graphics_context_set_stroke_color(target->ctx, color);
+        graphics_draw_rect(target->ctx, layout->frame);
+        return;
+    }
+    GRect frame = layout->frame;
+    if (frame.size.w <= 0 || frame.size.h <= 0) { return; }
+    int16_t x2 = frame.origin.x + frame.size.w - 1;
+    int16_t y2 = frame.origin.y + frame.size.h - 1;
+    plot_target_line(target, frame.origin, GPoint(x2, frame.origin.y), color);
+    plot_target_line(target, GPoint(frame.origin.x, y2), GPoint(x2, y2), color);
+    plot_target_line(target, frame.origin, GPoint(frame.origin.x, y2), color);
+    plot_target_line(target, GPoint(x2, frame.origin.y), GPoint(x2, y2), color);
+}
+
+static void plot_horizontal_line(const PlotTarget* target,
+                                 const PlotLayout* layout, int16_t value,
+                                 GColor color, uint8_t dash_length,
+                                 uint8_t gap_length) {
     int16_t y = plot_y_for_value(layout, value);
-    int16_t top = plot_min_i16(y, baseline);
-    int16_t height = (baseline > y ? baseline-y : y-baseline) + 1;
-    graphics_fill_rect(ctx, GRect(plot_x_for_index(layout, index, count),
-                                  top, 1, height), 0, GCornerNone);
+    int16_t x1 = layout->area.origin.x;
+    int16_t x2 = layout->area.origin.x + layout->area.size.w - 1;
+    plot_target_set_stroke_color(target, color);
+    if (dash_length == 0 || gap_length == 0) {
+        plot_target_line(target, GPoint(x1, y), GPoint(x2, y), color);
+        return;
+    }
+    for (int16_t x=x1; x<=x2; x += dash_length+gap_length) {
+        plot_target_line(target, GPoint(x, y),
+                         GPoint(plot_min_i16(x+dash_length-1, x2), y), color);
+    }
+}
+
+static void plot_vertical_line(const PlotTarget* target,
+                               const PlotLayout* layout, int16_t x_offset,
+                               GColor color, uint8_t dash_length,
+                               uint8_t gap_length) {
+    if (x_offset < 0 || x_offset >= layout->area.size.w) { return; }
+    int16_t x = layout->area.origin.x + x_offset;
+    int16_t y1 = layout->area.origin.y;
+    int16_t y2 = layout->area.origin.y + layout->area.size.h - 1;
+    plot_target_set_stroke_color(target, color);
+    if (dash_length == 0 || gap_length == 0) {
+        plot_target_line(target, GPoint(x, y1), GPoint(x, y2), color);
+        return;
+    }
+    for (int16_t y=y1; y<=y2; y += dash_length+gap_length) {
+        plot_target_line(target, GPoint(x, y),
+                         GPoint(x, plot_min_i16(y+dash_length-1, y2)), color);
+    }
 }
 
 PlotLayout plot_layout(GRect frame, int16_t left, int16_t top,
@@ -76,6 +438,24 @@ void plot_set_y_range(PlotLayout* layout, int16_t y_min, int16_t y_max) {
     }
     layout->y_min = y_min;
     layout->y_max = y_max;
+
+    // With y_scale = ceil((h-1) << shift / range) and 2^shift > range^2 the
+    // rounding error stays below 1/range for every offset in [0, range], so
+    // the multiply-shift matches floor(offset * (h-1) / range) exactly.
+    uint32_t range = (uint32_t)((int32_t)y_max-y_min);
+    uint8_t shift = 0;
+    while (shift < 32 && ((uint64_t)1 << shift) <= (uint64_t)range*range) {
+        shift += 1;
+    }
+    uint32_t steps = layout->area.size.h > 1 ? layout->area.size.h-1 : 0;
+    layout->y_shift = shift;
+    layout->y_scale = (uint32_t)((((uint64_t)steps << shift) + range-1) /
+                                 range);
+}
+
+void plot_use_framebuffer(PlotLayout* layout, GRect screen_frame) {
+    layout->use_framebuffer = true;
+    layout->screen_frame = screen_frame;
 }
 
 bool plot_set_y_range_from_u8(PlotLayout* layout, const uint8_t* values,
@@ -115,43 +495,21 @@ uint16_t plot_visible_u8_count(const PlotLayout* layout, uint16_t length,
 }
 
 void plot_draw_frame(GContext* ctx, const PlotLayout* layout, GColor color) {
-    graphics_context_set_stroke_color(ctx, color);
-    graphics_draw_rect(ctx, layout->frame);
+    plot_frame(&(PlotTarget){.ctx = ctx}, layout, color);
 }
 
 void plot_draw_horizontal_line(GContext* ctx, const PlotLayout* layout,
                                int16_t value, GColor color,
                                uint8_t dash_length, uint8_t gap_length) {
-    int16_t y = plot_y_for_value(layout, value);
-    int16_t x1 = layout->area.origin.x;
-    int16_t x2 = layout->area.origin.x + layout->area.size.w - 1;
-    graphics_context_set_stroke_color(ctx, color);
-    if (dash_length == 0 || gap_length == 0) {
-        graphics_draw_line(ctx, GPoint(x1, y), GPoint(x2, y));
-        return;
-    }
-    for (int16_t x=x1; x<=x2; x += dash_length+gap_length) {
-        graphics_draw_line(ctx, GPoint(x, y),
-                           GPoint(plot_min_i16(x+dash_length-1, x2), y));
-    }
+    plot_horizontal_line(&(PlotTarget){.ctx = ctx}, layout, value, color,
+                         dash_length, gap_length);
 }
 
 void plot_draw_vertical_line(GContext* ctx, const PlotLayout* layout,
                              int16_t x_offset, GColor color,
                              uint8_t dash_length, uint8_t gap_length) {
-    if (x_offset < 0 || x_offset >= layout->area.size.w) { return; }
-    int16_t x = layout->area.origin.x + x_offset;
-    int16_t y1 = layout->area.origin.y;
-    int16_t y2 = layout->area.origin.y + layout->area.size.h - 1;
-    graphics_context_set_stroke_color(ctx, color);
-    if (dash_length == 0 || gap_length == 0) {
-        graphics_draw_line(ctx, GPoint(x, y1), GPoint(x, y2));
-        return;
-    }
-    for (int16_t y=y1; y<=y2; y += dash_length+gap_length) {
-        graphics_draw_line(ctx, GPoint(x, y),
-                           GPoint(x, plot_min_i16(y+dash_length-1, y2)));
-    }
+    plot_vertical_line(&(PlotTarget){.ctx = ctx}, layout, x_offset, color,
+                       dash_length, gap_length);
 }
 
 void plot_draw_vertical_lines(GContext* ctx, const PlotLayout* layout,
@@ -164,13 +522,90 @@ void plot_draw_vertical_lines(GContext* ctx, const PlotLayout* layout,
     }
 }
 
+void plot_chrome_init(PlotChrome* chrome, GSize size,
+                      PlotChromeBuilder build) {
+    chrome->ctx = NULL;
+    chrome->build = build;
+    chrome->bitmap = gbitmap_create_blank(size, GBitmapFormat8Bit);
+    if (!chrome->bitmap) { return; }
+
+    GRect bounds = gbitmap_get_bounds(chrome->bitmap);
+    plot_bitmap_fill(chrome->bitmap, bounds, GColorClear);
+    build(chrome, bounds);
+}
+
+void plot_chrome_deinit(PlotChrome* chrome) {
+    if (chrome->bitmap) {
+        gbitmap_destroy(chrome->bitmap);
+        chrome->bitmap = NULL;
+    }
+}
+
+void plot_chrome_draw(GContext* ctx, PlotChrome* chrome, GRect bounds) {
+    if (chrome->bitmap) {
+        GRect bitmap_bounds = gbitmap_get_bounds(chrome->bitmap);
+        graphics_context_set_compositing_mode(ctx, GCompOpSet);
+        graphics_draw_bitmap_in_rect(ctx, chrome->bitmap,
+                                     GRect(bounds.origin.x, bounds.origin.y,
+                                           bitmap_bounds.size.w,
+                                           bitmap_bounds.size.h));
+        return;
+    }
+    if (!chrome->build) { return; }
+    chrome->ctx = ctx;
+    chrome->build(chrome, bounds);
+    chrome->ctx = NULL;
+}
+
+void plot_chrome_fill_rect(PlotChrome* chrome, GRect rect, GColor color) {
+    PlotTarget target = plot_chrome_target(chrome);
+    if (target.bitmap) {
+        plot_bitmap_fill(target.bitmap, rect, color);
+        return;
+    }
+    graphics_context_set_fill_color(target.ctx, color);
+    graphics_fill_rect(target.ctx, rect, 0, GCornerNone);
+}
+
+void plot_chrome_draw_frame(PlotChrome* chrome, const PlotLayout* layout,
+                            GColor color) {
+    PlotTarget target = plot_chrome_target(chrome);
+    plot_frame(&target, layout, color);
+}
+
+void plot_chrome_draw_horizontal_line(PlotChrome* chrome,
+                                      const PlotLayout* layout,
+                                      int16_t value, GColor color,
+                                      uint8_t dash_length,
+                                      uint8_t gap_length) {
+    PlotTarget target = plot_chrome_target(chrome);
+    plot_horizontal_line(&target, layout, value, color, dash_length,
+                         gap_length);
+}
+
+void plot_chrome_draw_vertical_lines(PlotChrome* chrome,
+                                     const PlotLayout* layout,
+                                     const int16_t* x_offsets, uint16_t count,
+                                     GColor color, uint8_t dash_length,
+                                     uint8_t gap_length) {
+    PlotTarget target = plot_chrome_target(chrome);
+    for (uint16_t i=0; i<count; i++) {
+        plot_vertical_line(&target, layout, x_offsets[i], color,
+                           dash_length, gap_length);
+    }
+}
+
 uint16_t plot_draw_filled_line(GContext* ctx, const PlotLayout* layout,
                                const int16_t* values, uint16_t count,
                                GColor color) {
-    graphics_context_set_fill_color(ctx, color);
-    for (uint16_t i=0; i<count; i++) {
-        plot_fill_column(ctx, layout, i, count, values[i]);
+    PlotColumnRun run;
+    PlotXStepper stepper;
+    plot_run_init(&run, ctx, layout, color);
+    plot_x_stepper_init(&stepper, layout, count);
+    for (uint16_t i=0; i<count; i++, plot_x_stepper_next(&stepper)) {
+        plot_run_add(&run, layout, stepper.x, values[i]);
     }
+    plot_run_finish(&run);
     return count;
 }
 
@@ -183,16 +618,18 @@ uint16_t plot_draw_u8_line(GContext* ctx, const PlotLayout* layout,
     bool has_last = false;
     uint16_t drawn = 0;
     uint16_t count = layout->area.size.w;
+    PlotXStepper stepper;
+    plot_x_stepper_init(&stepper, layout, count);
 
     graphics_context_set_stroke_color(ctx, color);
-    for (uint16_t i=0; i<count; i++) {
+    for (uint16_t i=0; i<count; i++, plot_x_stepper_next(&stepper)) {
         int16_t value;
         if (!plot_read_u8(values, length, start_index, i, missing_value,
                           decode_offset, false, &value)) {
             has_last = false;
             continue;
         }
-        int16_t x = plot_x_for_index(layout, i, count);
+        int16_t x = stepper.x;
         int16_t y = plot_y_for_value(layout, value);
         graphics_draw_line(ctx, GPoint(has_last ? last_x : x, has_last ? last_y : y),
                            GPoint(x, y));
@@ -211,15 +648,83 @@ uint16_t plot_draw_u8_filled_line(GContext* ctx, const PlotLayout* layout,
                                   GColor color) {
     uint16_t drawn = 0;
     uint16_t count = layout->area.size.w;
-    graphics_context_set_fill_color(ctx, color);
-    for (uint16_t i=0; i<count; i++) {
+    PlotColumnRun run;
+    PlotXStepper stepper;
+    plot_run_init(&run, ctx, layout, color);
+    plot_x_stepper_init(&stepper, layout, count);
+    for (uint16_t i=0; i<count; i++, plot_x_stepper_next(&stepper)) {
         int16_t value;
         if (plot_read_u8(values, length, start_index, i, missing_value,
                          decode_offset, hide_zero, &value)) {
-            plot_fill_column(ctx, layout, i, count, value);
+            plot_run_add(&run, layout, stepper.x, value);
             drawn += 1;
         }
     }
+    plot_run_finish(&run);
+    return drawn;
+}
+
+uint16_t plot_draw_min_max_line(GContext* ctx, const PlotLayout* layout,
+                                const int16_t* values, uint16_t count,
+                                int16_t missing_value, GColor color) {
+    PlotDecimator decimator;
+    plot_decimator_init(&decimator, layout, values, count, missing_value);
+    bool decimates = plot_decimator_decimates(&decimator);
+    int16_t x, low, high;
+    bool has_value;
+    int16_t last_x = 0;
+    int16_t last_top = 0;
+    int16_t last_bottom = 0;
+    bool has_last = false;
+    uint16_t drawn = 0;
+
+    graphics_context_set_stroke_color(ctx, color);
+    while (plot_decimator_next(&decimator, &x, &low, &high, &has_value)) {
+        if (!has_value) {
+            has_last = false;
+            continue;
+        }
+        int16_t top = plot_y_for_value(layout, high);
+        int16_t bottom = plot_y_for_value(layout, low);
+        if (!decimates) {
+            graphics_draw_line(ctx, GPoint(has_last ? last_x : x,
+                                           has_last ? last_top : top),
+                               GPoint(x, top));
+        } else {
+            // Stretch the column's span to touch its neighbour's so steep
+            // changes between columns stay connected.
+            int16_t from = top;
+            int16_t to = bottom;
+            if (has_last && top > last_bottom) { from = last_bottom; }
+            if (has_last && bottom < last_top) { to = last_top; }
+            graphics_draw_line(ctx, GPoint(x, from), GPoint(x, to));
+        }
+        last_x = x;
+        last_top = top;
+        last_bottom = bottom;
+        has_last = true;
+        drawn += 1;
+    }
+    return drawn;
+}
+
+uint16_t plot_draw_min_max_filled_line(GContext* ctx, const PlotLayout* layout,
+                                       const int16_t* values, uint16_t count,
+                                       int16_t missing_value, GColor color) {
+    PlotDecimator decimator;
+    PlotColumnRun run;
+    int16_t x, low, high;
+    bool has_value;
+    uint16_t drawn = 0;
+
+    plot_decimator_init(&decimator, layout, values, count, missing_value);
+    plot_run_init(&run, ctx, layout, color);
+    while (plot_decimator_next(&decimator, &x, &low, &high, &has_value)) {
+        if (!has_value) { continue; }
+        plot_run_add(&run, layout, x, high);
+        drawn += 1;
+    }
+    plot_run_finish(&run);
     return drawn;
 }
 
@@ -7,12 +7,24 @@ typedef struct {
     GRect area;
     int16_t y_min;
     int16_t y_max;
+    // Fixed-point y mapping precomputed by plot_set_y_range:
+    // y = bottom - ((value-y_min) * y_scale >> y_shift).
+    uint32_t y_scale;
+    uint8_t y_shift;
+    // Set by plot_use_framebuffer: filled plots then write the captured
+    // framebuffer, clipped to screen_frame, the layer's frame on screen.
+    bool use_framebuffer;
+    GRect screen_frame;
 } PlotLayout;
 
 PlotLayout plot_layout(GRect frame, int16_t left, int16_t top,
                        int16_t right, int16_t bottom,
                        int16_t y_min, int16_t y_max);
 void plot_set_y_range(PlotLayout* layout, int16_t y_min, int16_t y_max);
+// Lets the filled plots write column spans straight into the 8-bit
+// framebuffer instead of going through graphics_fill_rect.  They fall back
+// to graphics_fill_rect whenever the framebuffer cannot be captured.
+void plot_use_framebuffer(PlotLayout* layout, GRect screen_frame);
 bool plot_set_y_range_from_u8(PlotLayout* layout, const uint8_t* values,
                               uint16_t length, uint16_t start_index,
                               uint8_t missing_value, int16_t decode_offset);
@@ -46,6 +58,50 @@ uint16_t plot_draw_u8_filled_line(GContext* ctx, const PlotLayout* layout,
                                   uint16_t start_index, uint8_t missing_value,
                                   int16_t decode_offset, bool hide_zero,
                                   GColor color);
+// Series longer than the plot is wide are decimated to one column per pixel,
+// keeping each column's min and max so short spikes survive.  The line
+// variant strokes the min..max span of every column; the filled variant
+// fills up to each column's max.  Samples equal to missing_value are
+// skipped.  Both return the number of columns drawn.
+uint16_t plot_draw_min_max_line(GContext* ctx, const PlotLayout* layout,
+                                const int16_t* values, uint16_t count,
+                                int16_t missing_value, GColor color);
+uint16_t plot_draw_min_max_filled_line(GContext* ctx, const PlotLayout* layout,
+                                       const int16_t* values, uint16_t count,
+                                       int16_t missing_value, GColor color);
 void plot_fill_tail(GContext* ctx, const PlotLayout* layout,
                     uint16_t first_missing_index, uint16_t total_count,
                     int16_t height, GColor color);
+
+// Static decoration (frames, grid and reference lines, glyphs) rendered once
+// by a builder into an offscreen 8-bit bitmap that is transparent elsewhere,
+// then blitted with a single draw call per frame.  If the bitmap cannot be
+// allocated, plot_chrome_draw runs the builder against the context instead.
+typedef struct PlotChrome PlotChrome;
+typedef void (*PlotChromeBuilder)(PlotChrome* chrome, GRect bounds);
+
+struct PlotChrome {
+    GBitmap* bitmap;
+    GContext* ctx; // Set while the builder draws directly.
+    PlotChromeBuilder build;
+};
+
+void plot_chrome_init(PlotChrome* chrome, GSize size,
+                      PlotChromeBuilder build);
+void plot_chrome_deinit(PlotChrome* chrome);
+void plot_chrome_draw(GContext* ctx, PlotChrome* chrome, GRect bounds);
+
+// Builder primitives; same pixels as the plot_draw_* equivalents.
+void plot_chrome_fill_rect(PlotChrome* chrome, GRect rect, GColor color);
+void plot_chrome_draw_frame(PlotChrome* chrome, const PlotLayout* layout,
+                            GColor color);
+void plot_chrome_draw_horizontal_line(PlotChrome* chrome,
+                                      const PlotLayout* layout,
+                                      int16_t value, GColor color,
+                                      uint8_t dash_length,
+                                      uint8_t gap_length);
+void plot_chrome_draw_vertical_lines(PlotChrome* chrome,
+                                     const PlotLayout* layout,
+                                     const int16_t* x_offsets, uint16_t count,
+                                     GColor color, uint8_t dash_length,
+                                     uint8_t gap_length);
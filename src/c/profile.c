@@ -0,0 +1,172 @@
+#define PROFILE_NO_DRAW_COUNT
+#include "profile.h"
+
+#ifdef WATCHFACE_PROFILE
+
+typedef struct ProfileSample {
+    uint16_t elapsed_ms;
+    uint16_t draw_calls;
+} ProfileSample;
+
+typedef struct ProfileSlot {
+    const char* name;
+    uint32_t frames;
+    uint8_t next;
+    size_t heap_peak; // heap_bytes_used() after this slot's frames.
+    ProfileSample ring[PROFILE_RING_SIZE];
+} ProfileSlot;
+
+#define PROFILE_STACK_PAINT 0xA5
+
+static ProfileSlot s_profile_slots[PROFILE_SLOT_COUNT];
+static time_t s_profile_start_seconds;
+static uint16_t s_profile_start_ms;
+static uint16_t s_profile_draw_calls;
+static size_t s_heap_baseline;
+static size_t s_heap_retained;     // See profile_memory_retain_begin().
+static size_t s_heap_retain_start;
+static size_t s_heap_peak;
+static volatile uint8_t* s_stack_paint_low;  // Deepest painted byte.
+static volatile uint8_t* s_stack_paint_high; // One past the shallowest.
+
+static size_t profile_heap_sample(void) {
+    size_t used = heap_bytes_used();
+    if (used > s_heap_peak) { s_heap_peak = used; }
+    return used;
+}
+
+static uint32_t profile_elapsed_ms(void) {
+    time_t seconds;
+    uint16_t ms;
+    time_ms(&seconds, &ms);
+    return (uint32_t)(seconds-s_profile_start_seconds)*1000 + ms - s_profile_start_ms;
+}
+
+void profile_begin(void) {
+    s_profile_draw_calls = 0;
+    time_ms(&s_profile_start_seconds, &s_profile_start_ms);
+}
+
+void profile_end(uint8_t slot, const char* name) {
+    if (slot >= PROFILE_SLOT_COUNT) { return; }
+    uint32_t elapsed = profile_elapsed_ms();
+    ProfileSlot* profile = &s_profile_slots[slot];
+    profile->name = name;
+    profile->ring[profile->next] = (ProfileSample){
+        .elapsed_ms = elapsed > UINT16_MAX ? UINT16_MAX : elapsed,
+        .draw_calls = s_profile_draw_calls
+    };
+    profile->next = (profile->next+1) % PROFILE_RING_SIZE;
+    profile->frames += 1;
+
+    size_t heap_used = profile_heap_sample();
+    if (heap_used > profile->heap_peak) { profile->heap_peak = heap_used; }
+}
+
+void profile_count_draw(void) {
+    if (s_profile_draw_calls < UINT16_MAX) { s_profile_draw_calls += 1; }
+}
+
+// The stack grows down, so everything below this frame is unused while the
+// calling callback runs. The loop makes no calls, which would put a frame in
+// the range being painted, and noinline keeps this frame below the caller's.
+static void __attribute__((noinline)) profile_stack_paint(void) {
+    volatile uint8_t marker;
+    s_stack_paint_high = &marker - PROFILE_STACK_GUARD_BYTES;
+    s_stack_paint_low = s_stack_paint_high - PROFILE_STACK_PAINT_BYTES;
+    for (volatile uint8_t* p=s_stack_paint_low; p<s_stack_paint_high; p++) {
+        *p = PROFILE_STACK_PAINT;
+    }
+}
+
+// Bytes of the painted range that have been written since, counted from
+// its top. Interrupt frames land on the same stack, so this errs high.
+static size_t profile_stack_high_water(void) {
+    volatile uint8_t* p = s_stack_paint_low;
+    while (p < s_stack_paint_high && *p == PROFILE_STACK_PAINT) { p++; }
+    return s_stack_paint_high - p;
+}
+
+void profile_memory_start(void) {
+    s_heap_baseline = heap_bytes_used();
+    s_heap_peak = s_heap_baseline;
+    profile_memory_log("start");
+}
+
+void profile_memory_retain_begin(void) {
+    s_heap_retain_start = heap_bytes_used();
+}
+
+void profile_memory_retain_end(void) {
+    size_t used = profile_heap_sample();
+    if (used > s_heap_retain_start) {
+        s_heap_retained += used - s_heap_retain_start;
+    }
+}
+
+static void profile_stack_start_callback(void* context) {
+    profile_stack_paint();
+    layer_mark_dirty((Layer*)context);
+}
+
+// Init's own callees and the first frames would overwrite a range painted
+// during init, so painting waits for the event loop.
+void profile_stack_start(Layer* root) {
+    app_timer_register(0, profile_stack_start_callback, root);
+}
+
+void profile_memory_log(const char* where) {
+    size_t used = profile_heap_sample();
+    APP_LOG(APP_LOG_LEVEL_INFO, "heap %s: used %lu free %lu peak %lu",
+            where, (unsigned long)used, (unsigned long)heap_bytes_free(),
+            (unsigned long)s_heap_peak);
+}
+
+void profile_memory_report_leaks(void) {
+    size_t used = heap_bytes_used();
+    size_t expected = s_heap_baseline + s_heap_retained;
+    if (used > expected) {
+        APP_LOG(APP_LOG_LEVEL_WARNING, "heap leak: %lu bytes still allocated",
+                (unsigned long)(used - expected));
+    } else {
+        APP_LOG(APP_LOG_LEVEL_INFO, "heap: all memory released");
+    }
+}
+
+void profile_dump(void) {
+    // Before any logging, whose frames would land in the painted range.
+    size_t stack_used = s_stack_paint_high ? profile_stack_high_water() : 0;
+
+    for (int i=0; i<PROFILE_SLOT_COUNT; i++) {
+        const ProfileSlot* profile = &s_profile_slots[i];
+        if (!profile->frames) { continue; }
+
+        int count = profile->frames < PROFILE_RING_SIZE ? profile->frames : PROFILE_RING_SIZE;
+        uint16_t ms_min = UINT16_MAX, ms_max = 0;
+        uint16_t draw_min = UINT16_MAX, draw_max = 0;
+        uint32_t ms_sum = 0, draw_sum = 0;
+        for (int j=0; j<count; j++) {
+            const ProfileSample* sample = &profile->ring[j];
+            if (sample->elapsed_ms < ms_min) { ms_min = sample->elapsed_ms; }
+            if (sample->elapsed_ms > ms_max) { ms_max = sample->elapsed_ms; }
+            if (sample->draw_calls < draw_min) { draw_min = sample->draw_calls; }
+            if (sample->draw_calls > draw_max) { draw_max = sample->draw_calls; }
+            ms_sum += sample->elapsed_ms;
+            draw_sum += sample->draw_calls;
+        }
+        APP_LOG(APP_LOG_LEVEL_INFO, "%s: %lu frames, ms %u/%lu/%u, draws %u/%lu/%u, heap peak %lu",
+                profile->name, (unsigned long)profile->frames,
+                ms_min, (unsigned long)(ms_sum/count), ms_max,
+                draw_min, (unsigned long)(draw_sum/count), draw_max,
+                (unsigned long)profile->heap_peak);
+    }
+
+    profile_memory_log("dump");
+    if (s_stack_paint_high) {
+        APP_LOG(APP_LOG_LEVEL_INFO, "stack after init: %lu of %u painted bytes used",
+                (unsigned long)stack_used,
+                PROFILE_STACK_PAINT_BYTES);
+    }
+}
+
+#endif
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <pebble.h>
+
+// Render-time profiler for layer update procs. Compiled in only when
+// WATCHFACE_PROFILE is defined (see wscript); otherwise every macro below
+// expands to the plain update proc and nothing is recorded.
+//
+// Each slot keeps a ring of the last PROFILE_RING_SIZE frames (elapsed
+// milliseconds from time_ms() and graphics_* draw calls) and profile_dump()
+// logs min/mean/max over that ring through APP_LOG.
+//
+// The same build tracks the memory budget: heap_bytes_used() is sampled
+// after every profiled frame and every profile_memory_log(), keeping the
+// peak per slot and overall. Frames only sample it; the per-slot peaks are
+// logged by profile_dump(). Peaks are of the sampled points, not of every
+// allocation in between. profile_stack_start() paints the stack once init
+// has returned, so profile_dump() can report how deep the event handlers
+// and update procs have reached since.
+
+#define PROFILE_SLOT_COUNT 12
+#define PROFILE_RING_SIZE 16
+// Painted below a timer callback run straight from the event loop, the
+// depth handlers and update procs start from. Sized for the deepest locals
+// in the face, a HealthMinuteData[60] (under 1 KB) and a 256-byte persist
+// buffer, with room for the SDK frames under them. The SDK exposes no stack
+// bound to clamp to, so this assumes that much is free below the loop.
+#define PROFILE_STACK_PAINT_BYTES 1536
+#define PROFILE_STACK_GUARD_BYTES 64  // Left unpainted under the painting frame.
+
+#ifdef WATCHFACE_PROFILE
+
+void profile_begin(void);
+void profile_end(uint8_t slot, const char* name);
+void profile_count_draw(void);
+void profile_dump(void);
+
+// First thing in init: records the heap baseline.
+void profile_memory_start(void);
+// Allocations between these two calls belong to the system and outlive
+// deinit (the AppMessage buffers), so the leak report does not count them.
+void profile_memory_retain_begin(void);
+void profile_memory_retain_end(void);
+// Last thing in init: paints the stack from the event loop's first timer
+// callback, then redraws root so the first full frame is measured.
+void profile_stack_start(Layer* root);
+// Logs heap used/free/peak now; where names the call site.
+void profile_memory_log(const char* where);
+// Last thing in deinit: logs what is still allocated over the baseline.
+void profile_memory_report_leaks(void);
+
+// Declares <proc>_profiled, which times one call of proc into slot.
+#define PROFILED_UPDATE_PROC(slot, proc) \
+    static void proc##_profiled(Layer* layer, GContext* ctx) { \
+        profile_begin(); \
+        proc(layer, ctx); \
+        profile_end((slot), #proc); \
+    }
+#define PROFILED(proc) proc##_profiled
+
+// Count draw calls made between profile_begin() and profile_end(). A
+// function-like macro is not expanded inside its own replacement, so the
+// inner call reaches the SDK function.
+#ifndef PROFILE_NO_DRAW_COUNT
+#define graphics_draw_line(...) (profile_count_draw(), graphics_draw_line(__VA_ARGS__))
+#define graphics_draw_rect(...) (profile_count_draw(), graphics_draw_rect(__VA_ARGS__))
+#define graphics_fill_rect(...) (profile_count_draw(), graphics_fill_rect(__VA_ARGS__))
+#define graphics_draw_text(...) (profile_count_draw(), graphics_draw_text(__VA_ARGS__))
+#define graphics_draw_bitmap_in_rect(...) \
+    (profile_count_draw(), graphics_draw_bitmap_in_rect(__VA_ARGS__))
+#endif
+
+#else
+
+#define PROFILED_UPDATE_PROC(slot, proc)
+#define PROFILED(proc) proc
+#define profile_dump() ((void)0)
+#define profile_memory_start() ((void)0)
+#define profile_memory_retain_begin() ((void)0)
+#define profile_memory_retain_end() ((void)0)
+#define profile_stack_start(root) ((void)0)
+#define profile_memory_log(where) ((void)0)
+#define profile_memory_report_leaks() ((void)0)
+
+#endif
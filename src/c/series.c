@@ -0,0 +1,89 @@
+#include "series.h"
+
+static void time_series_summarize(TimeSeries* series) {
+    TimeSeriesSummary* summary = series->summary;
+    if (!summary) { return; }
+
+    uint16_t length = series->length;
+    uint8_t next_valid = length;
+    uint8_t low = UINT8_MAX;
+    uint8_t high = 0;
+    summary->next_valid[length] = length;
+    for (int i=length-1; i>=0; i--) {
+        uint8_t value = series->values[i];
+        if (value != series->missing_value) {
+            next_valid = i;
+            if (value < low) { low = value; }
+            if (value > high) { high = value; }
+        }
+        summary->next_valid[i] = next_valid;
+        summary->suffix_min[i] = low;
+        summary->suffix_max[i] = high;
+    }
+}
+
+void time_series_init(TimeSeries* series, uint8_t* values,
+                      TimeSeriesSummary* summary, uint16_t length,
+                      uint16_t step, uint8_t missing_value) {
+    series->values = values;
+    series->length = length;
+    series->summary = length <= TIME_SERIES_SUMMARY_LENGTH ? summary : NULL;
+    series->step = step > 0 ? step : 1;
+    series->missing_value = missing_value;
+    series->base_time = 0;
+    memset(values, missing_value, length);
+    time_series_summarize(series);
+}
+
+void time_series_set(TimeSeries* series, const uint8_t* values,
+                     time_t base_time) {
+    memcpy(series->values, values, series->length);
+    time_series_summarize(series);
+    time_series_set_base_time(series, base_time);
+}
+
+void time_series_set_base_time(TimeSeries* series, time_t base_time) {
+    // The phone's minutely and hourly feeds start on wall-clock boundaries,
+    // and minute ticks fire on them, so align sample 0 the same way.
+    series->base_time = base_time - base_time % series->step;
+}
+
+uint16_t time_series_offset(const TimeSeries* series, time_t now) {
+    if (series->base_time == 0 || now <= series->base_time) { return 0; }
+    time_t index = (now - series->base_time) / series->step;
+    return index < series->length ? (uint16_t)index : series->length;
+}
+
+bool time_series_has_values(const TimeSeries* series, uint16_t start,
+                            uint16_t count) {
+    if (start >= series->length) { return false; }
+    uint16_t end = count < series->length - start ? start + count : series->length;
+    if (series->summary) {
+        return series->summary->next_valid[start] < end;
+    }
+    for (uint16_t i=start; i<end; i++) {
+        if (series->values[i] != series->missing_value) { return true; }
+    }
+    return false;
+}
+
+bool time_series_range(const TimeSeries* series, uint16_t start,
+                       uint16_t count, uint8_t* low, uint8_t* high) {
+    if (!time_series_has_values(series, start, count)) { return false; }
+    uint16_t end = count < series->length - start ? start + count : series->length;
+    if (series->summary && end == series->length) {
+        *low = series->summary->suffix_min[start];
+        *high = series->summary->suffix_max[start];
+        return true;
+    }
+
+    *low = UINT8_MAX;
+    *high = 0;
+    for (uint16_t i=start; i<end; i++) {
+        uint8_t value = series->values[i];
+        if (value == series->missing_value) { continue; }
+        if (value < *low) { *low = value; }
+        if (value > *high) { *high = value; }
+    }
+    return true;
+}
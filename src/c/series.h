@@ -0,0 +1,46 @@
+#pragma once
+
+#include <pebble.h>
+
+#define TIME_SERIES_SUMMARY_LENGTH 60
+
+// Per-offset answers computed in one backward pass when data arrives, so
+// window queries during rendering do not rescan the samples.
+typedef struct {
+    uint8_t next_valid[TIME_SERIES_SUMMARY_LENGTH+1]; // First non-missing index >= i, or length.
+    uint8_t suffix_min[TIME_SERIES_SUMMARY_LENGTH];   // Over non-missing samples >= i.
+    uint8_t suffix_max[TIME_SERIES_SUMMARY_LENGTH];
+} TimeSeriesSummary;
+
+// A fixed-length series of byte samples taken every `step` seconds from
+// `base_time` on.  The sample covering a given time is found with one
+// division, so callers never count ticks to know where "now" is.
+typedef struct {
+    uint8_t* values;
+    TimeSeriesSummary* summary; // Optional; length <= TIME_SERIES_SUMMARY_LENGTH.
+    uint16_t length;
+    uint16_t step;       // Seconds between samples.
+    uint8_t missing_value;
+    time_t base_time;    // Start of values[0]; 0 until data arrives.
+} TimeSeries;
+
+void time_series_init(TimeSeries* series, uint8_t* values,
+                      TimeSeriesSummary* summary, uint16_t length,
+                      uint16_t step, uint8_t missing_value);
+// Copies length samples and anchors values[0] at the step boundary at or
+// before base_time.
+void time_series_set(TimeSeries* series, const uint8_t* values,
+                     time_t base_time);
+void time_series_set_base_time(TimeSeries* series, time_t base_time);
+// Index of the sample covering now, clamped to [0, length].  length means
+// the whole series lies in the past.
+uint16_t time_series_offset(const TimeSeries* series, time_t now);
+
+// Whether any of the count samples from start on is not missing_value.
+bool time_series_has_values(const TimeSeries* series, uint16_t start,
+                            uint16_t count);
+// Min and max of the non-missing samples in [start, start+count); false if
+// there are none.  O(1) with a summary when the window reaches the end of
+// the series, which is how the graphs use it.
+bool time_series_range(const TimeSeries* series, uint16_t start,
+                       uint16_t count, uint8_t* low, uint8_t* high);
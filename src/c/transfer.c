@@ -0,0 +1,97 @@
+#include "transfer.h"
+
+static uint16_t transfer_chunk_length(const Transfer* transfer,
+                                      uint16_t index) {
+    uint32_t start = (uint32_t)index*TRANSFER_CHUNK_SIZE;
+    if (start >= transfer->total_length) { return 0; }
+    uint32_t remaining = transfer->total_length - start;
+    return remaining < TRANSFER_CHUNK_SIZE ? remaining : TRANSFER_CHUNK_SIZE;
+}
+
+static bool transfer_is_complete(const Transfer* transfer) {
+    return (uint32_t)transfer->next_index*TRANSFER_CHUNK_SIZE >=
+           transfer->total_length;
+}
+
+// A reply that cannot be sent is not retried here: the phone times out and
+// resends the chunk, which is then answered as a duplicate.
+static void transfer_reply(const Transfer* transfer, uint8_t transfer_id,
+                           uint8_t status, uint16_t next_index) {
+    TransferReply reply = {
+        .transfer_id = transfer_id,
+        .status = status,
+        .next_index = next_index
+    };
+    DictionaryIterator* iter;
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {return;}
+    dict_write_data(iter, transfer->reply_key, (const uint8_t*)&reply,
+                    sizeof(reply));
+    app_message_outbox_send();
+}
+
+void transfer_init(Transfer* transfer, uint8_t* buffer, uint16_t capacity,
+                   uint32_t reply_key, TransferHandler on_complete) {
+    memset(transfer, 0, sizeof(*transfer));
+    transfer->buffer = buffer;
+    transfer->capacity = capacity;
+    transfer->reply_key = reply_key;
+    transfer->on_complete = on_complete;
+}
+
+void transfer_receive_chunk(Transfer* transfer, const uint8_t* data,
+                            uint16_t length) {
+    TransferChunkHeader header;
+    if (length < sizeof(header)) {return;}
+    memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+    length -= sizeof(header);
+
+    // Index 0 always starts over, even with the id of the last transfer:
+    // ids are one byte and the phone picks a new start after a restart, so
+    // a match says nothing about the payload. A resent chunk 0 is simply
+    // stored again.
+    if (header.index == 0) {
+        transfer->transfer_id = header.transfer_id;
+        transfer->key = header.key;
+        transfer->total_length = header.total_length;
+        transfer->next_index = 0;
+        transfer->active = header.total_length <= transfer->capacity;
+        if (!transfer->active) {
+            transfer_reply(transfer, header.transfer_id, TRANSFER_REJECT, 0);
+            return;
+        }
+    }
+
+    // A resend of a later chunk that is already stored, e.g. after a lost
+    // reply. This also holds once the transfer completed, so a lost final
+    // reply costs one chunk rather than the whole transfer.
+    if (header.transfer_id == transfer->transfer_id &&
+        header.index < transfer->next_index) {
+        transfer_reply(transfer, header.transfer_id, TRANSFER_ACK,
+                       transfer->next_index);
+        return;
+    }
+
+    // Transfers the watch does not know, e.g. after it restarted, start over.
+    if (!transfer->active || header.transfer_id != transfer->transfer_id) {
+        transfer_reply(transfer, header.transfer_id, TRANSFER_NACK, 0);
+        return;
+    }
+    if (header.index != transfer->next_index ||
+        length != transfer_chunk_length(transfer, header.index)) {
+        transfer_reply(transfer, header.transfer_id, TRANSFER_NACK,
+                       transfer->next_index);
+        return;
+    }
+
+    memcpy(transfer->buffer + (uint32_t)header.index*TRANSFER_CHUNK_SIZE,
+           data, length);
+    transfer->next_index += 1;
+    if (transfer_is_complete(transfer)) {
+        transfer->active = false;
+        transfer->on_complete(transfer->key, transfer->buffer,
+                              transfer->total_length);
+    }
+    transfer_reply(transfer, header.transfer_id, TRANSFER_ACK,
+                   transfer->next_index);
+}
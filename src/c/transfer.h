@@ -0,0 +1,54 @@
+#pragma once
+
+#include <pebble.h>
+
+// Receiving side of the chunked transfer protocol used by index.js for
+// payloads too large for one AppMessage.  Each chunk is a byte array that
+// starts with a TransferChunkHeader and carries TRANSFER_CHUNK_SIZE bytes
+// of payload (fewer in the last chunk).  Every chunk is answered with a
+// TransferReply naming the chunk the watch wants next, so the phone sends
+// one chunk at a time, resends on NACK and gives up on REJECT.  Chunks are
+// reassembled in a caller-provided buffer and handed over, whole, to the
+// completion handler under the message key the phone gave them.
+
+#define TRANSFER_CHUNK_SIZE 512
+
+enum TransferStatus {
+    TRANSFER_ACK = 1,    // Chunk stored (or already had); send next_index.
+    TRANSFER_NACK = 2,   // Out of order or malformed; resend from next_index.
+    TRANSFER_REJECT = 3  // Larger than the buffer; do not retry.
+};
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t transfer_id;
+    uint8_t key;           // Message key the payload is delivered as.
+    uint16_t index;        // Chunk index; chunk i starts at i*TRANSFER_CHUNK_SIZE.
+    uint16_t total_length; // Payload bytes over all chunks.
+} TransferChunkHeader;
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t transfer_id;
+    uint8_t status;        // TransferStatus.
+    uint16_t next_index;
+} TransferReply;
+
+typedef void (*TransferHandler)(uint32_t key, const uint8_t* data,
+                                uint16_t length);
+
+typedef struct {
+    uint8_t* buffer;
+    uint16_t capacity;
+    uint32_t reply_key;
+    TransferHandler on_complete;
+    uint8_t transfer_id;   // Of the current or last completed transfer.
+    uint8_t key;
+    uint16_t total_length;
+    uint16_t next_index;   // Chunks [0, next_index) are in buffer.
+    bool active;
+} Transfer;
+
+void transfer_init(Transfer* transfer, uint8_t* buffer, uint16_t capacity,
+                   uint32_t reply_key, TransferHandler on_complete);
+// Handles the data of one chunk tuple and sends the reply under reply_key.
+void transfer_receive_chunk(Transfer* transfer, const uint8_t* data,
+                            uint16_t length);
@@ -3,15 +3,25 @@
 #include <pebble-fctx/fpath.h>
 #include <pebble-fctx/ffont.h>
 #include "plot.h"
+#include "profile.h"
+#include "series.h"
+#include "transfer.h"
 
 // message buffer size:
 #define MESSAGE_BUF 1024
 #define WEATHER_DAY_GRAPH_SAMPLES 48
+#define WEATHER_DAY_GRAPH_STEP (30*SECONDS_PER_MINUTE)
+#define WEATHER_DAY_GRAPH_REFRESH_AHEAD (WEATHER_DAY_GRAPH_SAMPLES/2) // Samples left when we ask for more.
+#define WEATHER_PRECIP_SAMPLES 60
+#define WEATHER_PRECIP_STEP SECONDS_PER_MINUTE
 #define WEATHER_DAY_GRAPH_UNKNOWN 255
 #define WEATHER_TEMP_UNKNOWN ((int8_t)-128)
 #define WEATHER_TEMP_LEGACY_UNKNOWN ((int8_t)101)
 #define WEATHER_DETAIL_UNKNOWN 255
 #define WEATHER_PERCENT_UNKNOWN 101
+#define WEATHER_TEXT_NONE INT16_MIN
+#define WEATHER_ICON_SIZE 25
+#define WEATHER_ICON_COUNT 10
 #define WEATHER_PRECIP_GRAPH_WIDTH 49
 #define WEATHER_PRECIP_GRAPH_INNER_WIDTH (WEATHER_PRECIP_GRAPH_WIDTH - 4)
 #define TOP_DATA_BOTTOM 113
@@ -19,16 +29,24 @@
 #define REPORT_DATA_HEIGHT (TOP_DATA_BOTTOM - REPORT_DATA_Y)
 #define CALENDAR_DATA_Y 0
 #define CALENDAR_DATA_HEIGHT (TOP_DATA_BOTTOM - CALENDAR_DATA_Y)
-#define REPORT_TEXT_LENGTH 220
-#define CALENDAR_TEXT_LENGTH 256
+#define REPORT_TEXT_LENGTH 1024
+#define CALENDAR_TEXT_LENGTH 512
+// Holds the largest payload index.js sends in chunks, see transfer.h.
+#define TRANSFER_BUFFER_SIZE REPORT_TEXT_LENGTH
 #define CALENDAR_ENTRY_COUNT 8
 #define CALENDAR_ROW_HEIGHT 14
 #define CALENDAR_BAR_WIDTH 3
 #define CALENDAR_BAR_Y_OFFSET 4
 #define CALENDAR_BAR_HEIGHT 12
+#define HEALTH_BPM_SAMPLES 30
+#define LAYER_FINGERPRINT_UNSET INT16_MIN
+#define LAYER_FINGERPRINT_EMPTY (-1)
+#define HEALTH_BPM_DEFAULT 50
+#define PROFILE_DUMP_INTERVAL_MINUTES 10
 
 // TODO Add `const` where appropriate!
-// TODO not all memory is released?
+// deinit destroys everything init creates; profile_memory_report_leaks()
+// checks that in profiling builds.
 
 #define max(a,b) \
     ({ __typeof__ (a) _a = (a); \
@@ -65,8 +83,12 @@ static TextLayer* g_weather_wind_layer;       // Layer updated on weather events
 static TextLayer* g_report_layer;             // General purpose report layer - text generated in javascript.
 static Layer* g_calendar_layer;               // Upcoming calendar events generated in javascript.
 static struct tm g_local_time;
+static int16_t g_health_bpm_history[HEALTH_BPM_SAMPLES]; // One sample per minute, oldest first.
+static int16_t g_health_bpm_last = HEALTH_BPM_DEFAULT;
+static time_t g_health_bpm_minute; // Minute (time/60) the history ends at.
 static uint8_t g_battery_level;
 static int8_t g_connected; // TODO Should be bool!
+static time_t g_refresh_request_time; // When we last asked the phone for a refresh.
 static int8_t g_atemp = WEATHER_TEMP_UNKNOWN;
 static int8_t g_atempmax = WEATHER_TEMP_UNKNOWN;
 static int8_t g_atempmin = WEATHER_TEMP_UNKNOWN;
@@ -75,20 +97,67 @@ static int8_t g_tempmax = WEATHER_TEMP_UNKNOWN;
 static int8_t g_tempmin = WEATHER_TEMP_UNKNOWN;
 static uint8_t g_precipprob;
 static uint8_t g_weather_icon; // TODO Use less obfuscated data type!
-static uint8_t g_weather_precip_array[60];
-static uint8_t g_ticks_since_weather_array_update;
+static GBitmap* g_weather_icon_atlas;  // All icons, tinted at build time.
+static GBitmap* g_weather_icon_bitmap; // Sub-bitmap of the atlas for g_weather_icon.
+static GFont g_font_gothic_14;         // Resolved once in init.
+// A weather number formatted when its value arrives rather than on every
+// redraw. rect is the box it is laid out in, narrowed to the text's extent.
+typedef struct {
+    int16_t value; // WEATHER_TEXT_NONE when there is nothing to draw.
+    char text[5];
+    GRect rect;
+    GColor color;
+} WeatherText;
+enum WeatherTextSlot {
+    WEATHER_TEXT_TEMP,        // Temp layer, left column.
+    WEATHER_TEXT_TEMPMAX,
+    WEATHER_TEXT_TEMPMIN,
+    WEATHER_TEXT_ATEMP,       // Temp layer, right column.
+    WEATHER_TEXT_ATEMPMAX,
+    WEATHER_TEXT_ATEMPMIN,
+    WEATHER_TEXT_UV,          // Detail layer cells.
+    WEATHER_TEXT_CLOUD_COVER,
+    WEATHER_TEXT_VISIBILITY,
+    WEATHER_TEXT_COUNT
+};
+static WeatherText g_weather_texts[WEATHER_TEXT_COUNT];
+// Static decoration that is costly to redraw, rendered once; see
+// plot_chrome_init.  Simple frames and single lines are drawn directly.
+static PlotChrome g_health_bpm_heart_chrome;
+static PlotChrome g_weather_day_graph_chrome;
+static uint8_t g_weather_precip_array[WEATHER_PRECIP_SAMPLES];
 static uint8_t g_weather_day_atemp_array[WEATHER_DAY_GRAPH_SAMPLES];
 static uint8_t g_weather_day_precip_array[WEATHER_DAY_GRAPH_SAMPLES];
-static uint16_t g_ticks_since_weather_day_graph_update;
+static TimeSeries g_weather_precip_series;      // Minutely, over g_weather_precip_array.
+static TimeSeries g_weather_day_atemp_series;   // Half-hourly, over g_weather_day_atemp_array.
+static TimeSeries g_weather_day_precip_series;  // Half-hourly, over g_weather_day_precip_array.
+static TimeSeriesSummary g_weather_precip_summary;
+static TimeSeriesSummary g_weather_day_atemp_summary;
+static TimeSeriesSummary g_weather_day_precip_summary;
 static uint8_t g_weather_uv_index = WEATHER_DETAIL_UNKNOWN;
 static uint8_t g_weather_cloud_cover = WEATHER_PERCENT_UNKNOWN;
 static uint8_t g_weather_visibility_km = WEATHER_DETAIL_UNKNOWN;
+static uint8_t g_weather_humidity = WEATHER_PERCENT_UNKNOWN;
+static uint16_t g_weather_wind_speed = 1001;
+static uint8_t g_weather_record_flags;      // WEATHER_RECORD_HAS_* groups received so far.
 static bool g_show_short_precipgraph;
+// What each minute-driven layer last showed; the tick handler only marks a
+// layer dirty when its fingerprint changes.
+static int16_t g_precipgraph_fingerprint = LAYER_FINGERPRINT_UNSET;
+static int16_t g_weather_detail_fingerprint = LAYER_FINGERPRINT_UNSET;
+static int16_t g_weather_day_graph_fingerprint = LAYER_FINGERPRINT_UNSET;
 static char g_report_string[REPORT_TEXT_LENGTH];
-static char g_calendar_string[CALENDAR_TEXT_LENGTH];
+static char g_calendar_string[CALENDAR_TEXT_LENGTH]; // Rows, each NUL-terminated.
+static uint16_t g_calendar_length;                    // Bytes used in g_calendar_string.
+typedef struct {
+    uint16_t offset;
+    uint16_t length;
+} CalendarRow;
+static CalendarRow g_calendar_rows[CALENDAR_ENTRY_COUNT];
+static uint8_t g_calendar_row_count;
 static uint8_t g_calendar_color_array[CALENDAR_ENTRY_COUNT];
-static AppSync g_sync;
-static uint8_t g_sync_buffer[MESSAGE_BUF];
+static Transfer g_transfer;
+static uint8_t g_transfer_buffer[TRANSFER_BUFFER_SIZE];
 
 enum CommKey {
   WEATHER_ICON_KEY = 0x0,
@@ -109,27 +178,25 @@ enum CommKey {
   WEATHER_CLOUD_COVER_KEY = 0xF,
   WEATHER_VISIBILITY_KEY = 0x10,
   CALENDAR_KEY = 0x11,
-  CALENDAR_COLORS_KEY = 0x12
+  CALENDAR_COLORS_KEY = 0x12,
+  WEATHER_RECORD_KEY = 0x13, // Supersedes the separate WEATHER_* keys above.
+  WATCH_STATUS_KEY = 0x14,
+  TRANSFER_CHUNK_KEY = 0x15, // Phone to watch, see transfer.h.
+  TRANSFER_REPLY_KEY = 0x16, // Watch to phone.
+  REFRESH_REQUEST_KEY = 0x17 // Watch to phone.
 };
 
-static GColor weather_icon_color(uint8_t weather_icon) {
-    switch (weather_icon) {
-        case 1:  // clear day
-        case 9:  // partly cloudy day
-            return PBL_IF_COLOR_ELSE(GColorYellow, GColorWhite);
-        case 3:  // rain/thunderstorm
-        case 4:  // snow
-        case 5:  // sleet
-            return PBL_IF_COLOR_ELSE(GColorCyan, GColorWhite);
-        case 2:  // clear night
-        case 6:  // wind
-        case 7:  // fog/haze/dust
-        case 8:  // cloudy
-        case 10: // partly cloudy night
-        default:
-            return GColorWhite;
-    }
-}
+// Values of WATCH_STATUS_KEY sent to the phone.
+#define WATCH_STATUS_FRESH_START 1
+
+// Values of REFRESH_REQUEST_KEY: the sources the phone should fetch now
+// instead of waiting for its own schedule.
+#define REFRESH_WEATHER 0x01       // Current conditions and the day graph.
+#define REFRESH_PRECIPITATION 0x02 // The minutely series.
+#define REFRESH_REPORT 0x04
+#define REFRESH_CALENDAR 0x08
+#define REFRESH_ALL (REFRESH_WEATHER | REFRESH_PRECIPITATION | REFRESH_REPORT | REFRESH_CALENDAR)
+#define REFRESH_REQUEST_INTERVAL (10*SECONDS_PER_MINUTE) // Between requests while data stays stale.
 
 static GColor calendar_color(uint8_t color_id) {
     switch (color_id) {
@@ -149,78 +216,126 @@ static bool weather_temp_is_known(int8_t temp) {
     return temp != WEATHER_TEMP_UNKNOWN && temp != WEATHER_TEMP_LEGACY_UNKNOWN;
 }
 
-static void draw_weather_temp(GContext* ctx, int8_t temp, GColor color,
-                              GRect rect, GTextAlignment alignment) {
-    if (!weather_temp_is_known(temp)) {return;}
+static void draw_weather_text(GContext* ctx, const WeatherText* text) {
+    if (text->value == WEATHER_TEXT_NONE) {return;}
 
-    char temp_string[5];
-    snprintf(temp_string, sizeof temp_string, "%d", temp);
-    graphics_context_set_text_color(ctx, color);
-    graphics_draw_text(ctx, temp_string,
-                       fonts_get_system_font(FONT_KEY_GOTHIC_14),
-                       rect, GTextOverflowModeWordWrap, alignment, NULL);
+    graphics_context_set_text_color(ctx, text->color);
+    graphics_draw_text(ctx, text->text, g_font_gothic_14, text->rect,
+                       GTextOverflowModeWordWrap, GTextAlignmentLeft, NULL);
 }
 
-static bool weather_precipgraph_has_visible_values(void) {
-    uint16_t start = g_ticks_since_weather_array_update;
-    uint16_t count = sizeof(g_weather_precip_array);
-    if (start >= count) { return false; }
+static uint16_t weather_precip_offset(void) {
+    return time_series_offset(&g_weather_precip_series, time(NULL));
+}
 
-    uint16_t end = start + WEATHER_PRECIP_GRAPH_INNER_WIDTH;
-    if (end > count) { end = count; }
-    for (uint16_t i=start; i<end; i++) {
-        if (g_weather_precip_array[i] != 0) { return true; }
-    }
-    return false;
+// Zero is the precip series' missing value, so this asks whether any rain
+// falls within the visible window.
+static bool weather_precipgraph_has_visible_values(void) {
+    return time_series_has_values(&g_weather_precip_series,
+                                  weather_precip_offset(),
+                                  WEATHER_PRECIP_GRAPH_INNER_WIDTH);
 }
 
 static bool weather_short_precipgraph_visible(void) {
     return g_show_short_precipgraph && weather_precipgraph_has_visible_values();
 }
 
-static uint8_t palette_size_for_format(GBitmapFormat format) {
-    switch (format) {
-        case GBitmapFormat1BitPalette: return 2;
-        case GBitmapFormat2BitPalette: return 4;
-        case GBitmapFormat4BitPalette: return 16;
-        default: return 0;
+static int16_t weather_precipgraph_fingerprint(void) {
+    if (!g_show_short_precipgraph || !weather_precipgraph_has_visible_values()) {
+        return LAYER_FINGERPRINT_EMPTY;
+    }
+    return weather_precip_offset();
+}
+
+static int16_t weather_day_graph_offset(void) {
+    return time_series_offset(&g_weather_day_atemp_series, time(NULL));
+}
+
+static void mark_dirty_if_changed(Layer* layer, int16_t* fingerprint,
+                                  int16_t value) {
+    if (*fingerprint == value) {return;}
+    *fingerprint = value;
+    layer_mark_dirty(layer);
+}
+
+static bool health_minute_bpm(const HealthMinuteData* minute_data,
+                              int16_t* out_bpm) {
+    if (minute_data->is_invalid || minute_data->heart_rate_bpm == 0) {
+        return false;
     }
+    *out_bpm = minute_data->heart_rate_bpm;
+    return true;
 }
 
-static void tint_weather_icon_bitmap(GBitmap* bitmap, GColor tint_color) {
-    GBitmapFormat format = gbitmap_get_format(bitmap);
-    uint8_t palette_size = palette_size_for_format(format);
-    if (palette_size) {
-        GColor* palette = gbitmap_get_palette(bitmap);
-        if (!palette) {return;}
-        for (int i=0; i<palette_size; i++) {
-            if (palette[i].a != 0) {
-                uint8_t alpha = palette[i].a;
-                palette[i] = tint_color;
-                palette[i].a = alpha;
-            }
+// Fill the whole bpm history from the last hour of minute data. Reading 60
+// minutes lets the plotted 30-minute window start from the most recent valid
+// point before it.
+static void health_bpm_history_seed(void) {
+    HealthMinuteData minute_data[2*HEALTH_BPM_SAMPLES];
+    time_t t2 = time(NULL);
+    g_health_bpm_minute = t2 / SECONDS_PER_MINUTE;
+    time_t t1 = t2 - 2*HEALTH_BPM_SAMPLES*SECONDS_PER_MINUTE;
+    uint32_t count = health_service_get_minute_history(minute_data,
+                                                       ARRAY_LENGTH(minute_data),
+                                                       &t1, &t2);
+    uint32_t skip = count > HEALTH_BPM_SAMPLES ? count-HEALTH_BPM_SAMPLES : 0;
+
+    g_health_bpm_last = HEALTH_BPM_DEFAULT;
+    for (uint32_t i=0; i<ARRAY_LENGTH(minute_data); i++) {
+        if (i < count) {
+            health_minute_bpm(&minute_data[i], &g_health_bpm_last);
+        }
+        if (i >= skip && i-skip < HEALTH_BPM_SAMPLES) {
+            g_health_bpm_history[i-skip] = g_health_bpm_last;
         }
-        return;
     }
+}
 
-    if (format != GBitmapFormat8Bit) {return;}
+// Shift the history by one minute, carrying the last valid bpm forward when
+// the newest minute record is missing or not yet written. Returns false when
+// the window was flat at the new value, i.e. the plot would not change, or
+// when the history already ends at this minute.
+static bool health_bpm_history_append(void) {
+    HealthMinuteData minute_data[2];
+    time_t t2 = time(NULL);
+    if (t2 / SECONDS_PER_MINUTE == g_health_bpm_minute) {return false;}
+    g_health_bpm_minute = t2 / SECONDS_PER_MINUTE;
+    time_t t1 = t2 - ARRAY_LENGTH(minute_data)*SECONDS_PER_MINUTE;
+    uint32_t count = health_service_get_minute_history(minute_data,
+                                                       ARRAY_LENGTH(minute_data),
+                                                       &t1, &t2);
+    for (uint32_t i=0; i<count; i++) {
+        health_minute_bpm(&minute_data[i], &g_health_bpm_last);
+    }
 
-    GRect bounds = gbitmap_get_bounds(bitmap);
-    uint8_t* data = gbitmap_get_data(bitmap);
-    uint16_t bytes_per_row = gbitmap_get_bytes_per_row(bitmap);
-    if (!data || bytes_per_row == 0) {return;}
+    bool changed =
+        g_health_bpm_history[HEALTH_BPM_SAMPLES-1] != g_health_bpm_last ||
+        memcmp(&g_health_bpm_history[0], &g_health_bpm_history[1],
+               (HEALTH_BPM_SAMPLES-1)*sizeof(g_health_bpm_history[0])) != 0;
+    memmove(&g_health_bpm_history[0], &g_health_bpm_history[1],
+            (HEALTH_BPM_SAMPLES-1)*sizeof(g_health_bpm_history[0]));
+    g_health_bpm_history[HEALTH_BPM_SAMPLES-1] = g_health_bpm_last;
+    return changed;
+}
 
-    for (int y=0; y<bounds.size.h; y++) {
-        for (int x=0; x<bounds.size.w; x++) {
-            uint8_t* pixel = data + y * bytes_per_row + x;
-            GColor pixel_color = (GColor){.argb = *pixel};
-            if (pixel_color.a != 0) {
-                GColor tinted_pixel = tint_color;
-                tinted_pixel.a = pixel_color.a;
-                *pixel = tinted_pixel.argb;
-            }
-        }
+// Icons are 1-based, in the order tools/weather_atlas.py packs them.
+// TODO Mark in readme https://icons8.com/ as icons' source!
+static GRect weather_icon_atlas_rect(uint8_t weather_icon) {
+    return GRect((weather_icon-1)*WEATHER_ICON_SIZE, 0,
+                 WEATHER_ICON_SIZE, WEATHER_ICON_SIZE);
+}
+
+// Cut the icon out of the pre-tinted atlas once per change of g_weather_icon
+// so the update proc only blits the cached bitmap.
+static void weather_icon_bitmap_update(void) {
+    if (g_weather_icon_bitmap) {
+        gbitmap_destroy(g_weather_icon_bitmap);
+        g_weather_icon_bitmap = NULL;
     }
+    if (!g_weather_icon_atlas ||
+        g_weather_icon < 1 || g_weather_icon > WEATHER_ICON_COUNT) {return;}
+    g_weather_icon_bitmap = gbitmap_create_as_sub_bitmap(
+        g_weather_icon_atlas, weather_icon_atlas_rect(g_weather_icon));
 }
 
 // --------------------------------------------------------------------------
@@ -256,100 +371,81 @@ static void on_connection_layer_update(Layer* layer, GContext* ctx) {
     graphics_draw_line(ctx, GPoint(0, 9), GPoint(6, 3));
 }
 
-static void on_health_bpm_graph_layer_update(Layer* layer, GContext* ctx) {
-    HealthMinuteData minute_data[60];
-    int16_t bpm_values[30];
-    int16_t last_bpm = 50;
-    time_t t2 = time(NULL);
-    time_t t1 = t2 - SECONDS_PER_HOUR;
-    // TODO Why not health_service_get_minute_history(minute_data, sizeof(minute_data), &t1, &t2));
-    health_service_get_minute_history(&minute_data[0], 60, &t1, &t2);
+static PlotLayout health_bpm_graph_layout(GRect bounds) {
+    return plot_layout(bounds, 2, 1, 2, 1, 50, 145);
+}
 
-    for (int i=0; i<60; i++) {
-        if (!minute_data[i].is_invalid && minute_data[i].heart_rate_bpm != 0) {
-            last_bpm = minute_data[i].heart_rate_bpm;
-        }
-        // Read 60 minutes so the plotted 30-minute window can start from the
-        // most recent valid point before it.
-        if (i >= 30) {
-            bpm_values[i-30] = last_bpm;
-        }
-    }
+static void health_bpm_heart_chrome(PlotChrome* chrome, GRect bounds) {
+    GColor color = PBL_IF_COLOR_ELSE(GColorRed, GColorWhite);
+    plot_chrome_fill_rect(chrome, GRect(1, 3, 2, 1), color);
+    plot_chrome_fill_rect(chrome, GRect(5, 3, 2, 1), color);
+    plot_chrome_fill_rect(chrome, GRect(0, 4, 8, 2), color);
+    plot_chrome_fill_rect(chrome, GRect(1, 6, 6, 1), color);
+    plot_chrome_fill_rect(chrome, GRect(2, 7, 4, 1), color);
+    plot_chrome_fill_rect(chrome, GRect(3, 8, 2, 1), color);
+    plot_chrome_fill_rect(chrome, GRect(4, 9, 1, 1), color);
+}
 
-    PlotLayout plot = plot_layout(layer_get_bounds(layer), 2, 1, 2, 1, 50, 145);
+static PlotLayout weather_precipgraph_layout(GRect bounds) {
+    return plot_layout(bounds, 2, 1, 2, 1, 0, 240);
+}
+
+static PlotLayout weather_day_graph_layout(GRect bounds) {
+    return plot_layout(bounds, 1, 1, 1, 1, 0, 100);
+}
+
+static void weather_day_graph_chrome(PlotChrome* chrome, GRect bounds) {
+    static const int16_t grid_lines[] = {12, 24, 36};
+    PlotLayout plot = weather_day_graph_layout(bounds);
+    plot_chrome_draw_frame(chrome, &plot, GColorWhite);
+    plot_chrome_draw_vertical_lines(chrome, &plot, grid_lines,
+                                    ARRAY_LENGTH(grid_lines),
+                                    GColorDarkGray, 0, 0);
+}
+
+static void on_health_bpm_graph_layer_update(Layer* layer, GContext* ctx) {
+    GRect bounds = layer_get_bounds(layer);
+    PlotLayout plot = health_bpm_graph_layout(bounds);
+    // Direct child of the window root, so its frame is its screen rect.
+    plot_use_framebuffer(&plot, layer_get_frame(layer));
     plot_draw_horizontal_line(ctx, &plot, 95, GColorDarkGray, 0, 0);
-    plot_draw_filled_line(ctx, &plot, bpm_values, ARRAY_LENGTH(bpm_values),
+    plot_draw_filled_line(ctx, &plot, g_health_bpm_history,
+                          ARRAY_LENGTH(g_health_bpm_history),
                           PBL_IF_COLOR_ELSE(GColorRed, GColorWhite));
     plot_draw_frame(ctx, &plot, GColorWhite);
     plot_draw_vertical_line(ctx, &plot, 14, GColorDarkGray, 0, 0);
 }
 
 static void on_health_bpm_heart_layer_update(Layer* layer, GContext* ctx) {
-    graphics_context_set_fill_color(ctx, PBL_IF_COLOR_ELSE(GColorRed, GColorWhite));
-    graphics_fill_rect(ctx, GRect(1, 3, 2, 1), 0, GCornerNone);
-    graphics_fill_rect(ctx, GRect(5, 3, 2, 1), 0, GCornerNone);
-    graphics_fill_rect(ctx, GRect(0, 4, 8, 2), 0, GCornerNone);
-    graphics_fill_rect(ctx, GRect(1, 6, 6, 1), 0, GCornerNone);
-    graphics_fill_rect(ctx, GRect(2, 7, 4, 1), 0, GCornerNone);
-    graphics_fill_rect(ctx, GRect(3, 8, 2, 1), 0, GCornerNone);
-    graphics_fill_rect(ctx, GRect(4, 9, 1, 1), 0, GCornerNone);
+    plot_chrome_draw(ctx, &g_health_bpm_heart_chrome, layer_get_bounds(layer));
 }
 
 static void on_weather_temp_layer_update(Layer* layer, GContext* ctx) {
-    draw_weather_temp(ctx, g_temp, GColorWhite,
-                      GRect(0,7,18,15), GTextAlignmentRight);
-    draw_weather_temp(ctx, g_tempmax, PBL_IF_COLOR_ELSE(GColorRed, GColorWhite),
-                      GRect(16-((g_tempmax<0)?5:0),0,18,15),
-                      GTextAlignmentLeft);
-    draw_weather_temp(ctx, g_tempmin, PBL_IF_COLOR_ELSE(GColorCyan, GColorWhite),
-                      GRect(16-((g_tempmin<0)?5:0),14,18,15),
-                      GTextAlignmentLeft);
-    draw_weather_temp(ctx, g_atemp, GColorWhite,
-                      GRect(20,7,18,15), GTextAlignmentRight);
-    draw_weather_temp(ctx, g_atempmax, PBL_IF_COLOR_ELSE(GColorRed, GColorWhite),
-                      GRect(38-((g_atempmax<0)?5:0),0,18,15),
-                      GTextAlignmentLeft);
-    draw_weather_temp(ctx, g_atempmin, PBL_IF_COLOR_ELSE(GColorCyan, GColorWhite),
-                      GRect(38-((g_atempmin<0)?5:0),14,18,15),
-                      GTextAlignmentLeft);
+    for (int i=WEATHER_TEXT_TEMP; i<=WEATHER_TEXT_ATEMPMIN; i++) {
+        draw_weather_text(ctx, &g_weather_texts[i]);
+    }
 }
 
 static void on_weather_icon_layer_update(Layer* layer, GContext* ctx) {
-    static GBitmap *s_bitmap;
-    if (s_bitmap) {
-      gbitmap_destroy(s_bitmap);
-    }
-    uint32_t resource_id = 0;
-    if (g_weather_icon) {
-        switch (g_weather_icon) { // TODO Mark in readme https://icons8.com/ as icons' source!
-            case  1: resource_id = RESOURCE_ID_Sun_25; break;
-            case  2: resource_id = RESOURCE_ID_Bright_Moon_25; break;
-            case  3: resource_id = RESOURCE_ID_Rain_25; break;
-            case  4: resource_id = RESOURCE_ID_Snow_25; break;
-            case  5: resource_id = RESOURCE_ID_Sleet_25; break;
-            case  6: resource_id = RESOURCE_ID_Air_Element_25; break;
-            case  7: resource_id = RESOURCE_ID_Dust_25; break;
-            case  8: resource_id = RESOURCE_ID_Clouds_25; break;
-            case  9: resource_id = RESOURCE_ID_Partly_Cloudy_Day_25; break;
-            case 10: resource_id = RESOURCE_ID_Partly_Cloudy_Night_25; break;
-        }
-        s_bitmap  = gbitmap_create_with_resource(resource_id);
-        if (!s_bitmap) {return;}
-        tint_weather_icon_bitmap(s_bitmap, weather_icon_color(g_weather_icon));
-        graphics_context_set_compositing_mode(ctx, GCompOpSet);
-        graphics_draw_bitmap_in_rect(ctx, s_bitmap, GRect(0,0,25,25));
-    }
+    if (!g_weather_icon_bitmap) {return;}
+    graphics_context_set_compositing_mode(ctx, GCompOpSet);
+    graphics_draw_bitmap_in_rect(ctx, g_weather_icon_bitmap,
+                                 GRect(0, 0, WEATHER_ICON_SIZE, WEATHER_ICON_SIZE));
 }
 
 static void on_weather_precipgraph_layer_update(Layer* layer, GContext* ctx) {
     if (!g_show_short_precipgraph) { return; }
 
     static const int16_t grid_lines[] = {15, 30};
-    PlotLayout plot = plot_layout(layer_get_bounds(layer), 2, 1, 2, 1, 0, 240);
+    GRect bounds = layer_get_bounds(layer);
+    PlotLayout plot = weather_precipgraph_layout(bounds);
+    plot_use_framebuffer(&plot, layer_get_frame(layer));
+    const TimeSeries* series = &g_weather_precip_series;
+    uint16_t minute_offset = weather_precip_offset();
 
     uint16_t drawn = plot_draw_u8_filled_line(
-        ctx, &plot, g_weather_precip_array, sizeof(g_weather_precip_array),
-        g_ticks_since_weather_array_update, 0, 0, true,
+        ctx, &plot, series->values, series->length,
+        minute_offset, 0, 0, true,
         PBL_IF_COLOR_ELSE(GColorCyan, GColorWhite));
     if (drawn == 0) {
         return;
@@ -358,10 +454,9 @@ static void on_weather_precipgraph_layer_update(Layer* layer, GContext* ctx) {
     plot_draw_frame(ctx, &plot, GColorWhite);
     plot_draw_vertical_lines(ctx, &plot, grid_lines, ARRAY_LENGTH(grid_lines),
                              GColorDarkGray, 0, 0);
-    if (g_ticks_since_weather_array_update > 15) {
+    if (minute_offset > 15) {
         uint16_t first_missing = plot_visible_u8_count(
-            &plot, sizeof(g_weather_precip_array),
-            g_ticks_since_weather_array_update);
+            &plot, series->length, minute_offset);
         plot_fill_tail(ctx, &plot, first_missing, plot.area.size.w, 2,
                        GColorDarkGray);
     }
@@ -379,16 +474,13 @@ static GColor weather_visibility_color(uint8_t visibility_km) {
     return GColorWhite;
 }
 
-static void draw_weather_detail(GContext* ctx, const char* value,
-                                const char* label, GRect rect,
-                                GColor color) {
-    graphics_context_set_text_color(ctx, color);
-    graphics_draw_text(ctx, value,
-                       fonts_get_system_font(FONT_KEY_GOTHIC_14),
-                       GRect(rect.origin.x, 2, rect.size.w, 15),
-                       GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
-    graphics_draw_text(ctx, label,
-                       fonts_get_system_font(FONT_KEY_GOTHIC_14),
+// The label is drawn in the value's colour.
+static void draw_weather_detail(GContext* ctx, const WeatherText* value,
+                                const char* label, GRect rect) {
+    if (value->value == WEATHER_TEXT_NONE) {return;}
+
+    draw_weather_text(ctx, value);
+    graphics_draw_text(ctx, label, g_font_gothic_14,
                        GRect(rect.origin.x, 13, rect.size.w, 15),
                        GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
 }
@@ -407,142 +499,173 @@ static void on_weather_detail_layer_update(Layer* layer, GContext* ctx) {
     GRect bounds = layer_get_bounds(layer);
     if (weather_short_precipgraph_visible()) { return; }
 
-    char value_string[5];
-
-    if (g_weather_uv_index != WEATHER_DETAIL_UNKNOWN) {
-        snprintf(value_string, sizeof value_string, "%d", g_weather_uv_index);
-        draw_weather_detail(ctx, value_string, "UV",
-                            weather_detail_cell(bounds, 0),
-                            weather_uv_color(g_weather_uv_index));
-    }
-
-    if (g_weather_cloud_cover < WEATHER_PERCENT_UNKNOWN) {
-        snprintf(value_string, sizeof value_string, "%d", g_weather_cloud_cover);
-        draw_weather_detail(ctx, value_string, "%",
-                            weather_detail_cell(bounds, 1), GColorWhite);
-    }
-
-    if (g_weather_visibility_km != WEATHER_DETAIL_UNKNOWN) {
-        snprintf(value_string, sizeof value_string, "%d", g_weather_visibility_km);
-        draw_weather_detail(ctx, value_string, "km",
-                            weather_detail_cell(bounds, 2),
-                            weather_visibility_color(g_weather_visibility_km));
-    }
+    draw_weather_detail(ctx, &g_weather_texts[WEATHER_TEXT_UV], "UV",
+                        weather_detail_cell(bounds, 0));
+    draw_weather_detail(ctx, &g_weather_texts[WEATHER_TEXT_CLOUD_COVER], "%",
+                        weather_detail_cell(bounds, 1));
+    draw_weather_detail(ctx, &g_weather_texts[WEATHER_TEXT_VISIBILITY], "km",
+                        weather_detail_cell(bounds, 2));
 }
 
 static void on_weather_day_graph_layer_update(Layer* layer, GContext* ctx) {
-    static const int16_t grid_lines[] = {12, 24, 36};
-    PlotLayout plot = plot_layout(layer_get_bounds(layer), 1, 1, 1, 1, 0, 100);
-    uint8_t half_hour_offset = min(WEATHER_DAY_GRAPH_SAMPLES,
-                                   g_ticks_since_weather_day_graph_update/30);
-    bool has_temp = plot_has_u8_values(&plot, g_weather_day_atemp_array,
-                                       WEATHER_DAY_GRAPH_SAMPLES,
-                                       half_hour_offset,
-                                       WEATHER_DAY_GRAPH_UNKNOWN);
-    bool has_precip = plot_has_u8_values(&plot, g_weather_day_precip_array,
-                                         WEATHER_DAY_GRAPH_SAMPLES,
-                                         half_hour_offset,
-                                         WEATHER_DAY_GRAPH_UNKNOWN);
+    GRect bounds = layer_get_bounds(layer);
+    PlotLayout plot = weather_day_graph_layout(bounds);
+    plot_use_framebuffer(&plot, layer_get_frame(layer));
+    uint8_t half_hour_offset = weather_day_graph_offset();
+    uint16_t visible = plot_visible_u8_count(&plot, WEATHER_DAY_GRAPH_SAMPLES,
+                                             half_hour_offset);
+    uint8_t atemp_low, atemp_high;
+    bool has_temp = time_series_range(&g_weather_day_atemp_series,
+                                      half_hour_offset, visible,
+                                      &atemp_low, &atemp_high);
+    bool has_precip = time_series_has_values(&g_weather_day_precip_series,
+                                             half_hour_offset, visible);
 
     if (!has_temp && !has_precip) {
         return;
     }
 
-    plot_draw_frame(ctx, &plot, GColorWhite);
-    plot_draw_vertical_lines(ctx, &plot, grid_lines, ARRAY_LENGTH(grid_lines),
-                             GColorDarkGray, 0, 0);
-
+    // The frame and grid go over the precipitation but under the
+    // temperature line, which never reaches the frame.
     if (has_precip) {
-        plot_set_y_range(&plot, 0, 100);
         plot_draw_u8_filled_line(ctx, &plot, g_weather_day_precip_array,
                                  WEATHER_DAY_GRAPH_SAMPLES, half_hour_offset,
                                  WEATHER_DAY_GRAPH_UNKNOWN, 0, true,
                                  PBL_IF_COLOR_ELSE(GColorCyan, GColorWhite));
-        plot_draw_vertical_lines(ctx, &plot, grid_lines, ARRAY_LENGTH(grid_lines),
-                                 GColorDarkGray, 0, 0);
     }
+    plot_chrome_draw(ctx, &g_weather_day_graph_chrome, bounds);
 
     if (has_temp) {
-        plot_set_y_range_from_u8(&plot, g_weather_day_atemp_array,
-                                 WEATHER_DAY_GRAPH_SAMPLES,
-                                 half_hour_offset,
-                                 WEATHER_DAY_GRAPH_UNKNOWN,
-                                 -100);
+        plot_set_y_range(&plot, atemp_low - 100, atemp_high - 100);
         plot_draw_u8_line(ctx, &plot, g_weather_day_atemp_array,
                           WEATHER_DAY_GRAPH_SAMPLES, half_hour_offset,
                           WEATHER_DAY_GRAPH_UNKNOWN, -100,
                           PBL_IF_COLOR_ELSE(GColorRed, GColorWhite));
     }
-
-    plot_draw_frame(ctx, &plot, GColorWhite);
 }
 
 static void on_calendar_layer_update(Layer* layer, GContext* ctx) {
     GRect bounds = layer_get_bounds(layer);
-    int16_t y = 0;
-    uint8_t row_index = 0;
-    const char* cursor = g_calendar_string;
-    GFont font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
-
     graphics_context_set_text_color(ctx, GColorWhite);
-    while (*cursor && row_index < CALENDAR_ENTRY_COUNT &&
-           y + CALENDAR_ROW_HEIGHT <= bounds.size.h) {
-        char row[CALENDAR_TEXT_LENGTH];
-        uint16_t line_len = 0;
-        uint16_t copy_len = 0;
-
-        while (cursor[line_len] && cursor[line_len] != '\n') {
-            if (copy_len < sizeof(row) - 1) {
-                row[copy_len++] = cursor[line_len];
-            }
-            line_len++;
-        }
-        row[copy_len] = '\0';
-
-        if (copy_len > 0) {
-            graphics_context_set_fill_color(ctx,
-                                            calendar_color(g_calendar_color_array[row_index]));
-            int16_t bar_y = y + CALENDAR_BAR_Y_OFFSET;
-            int16_t bar_height = min(CALENDAR_BAR_HEIGHT, bounds.size.h - bar_y);
-            if (bar_height > 0) {
-                graphics_fill_rect(ctx, GRect(2, bar_y, CALENDAR_BAR_WIDTH,
-                                              bar_height),
-                                   0, GCornerNone);
-            }
-            graphics_context_set_text_color(ctx, GColorWhite);
-            graphics_draw_text(ctx, row, font,
-                               GRect(2 + CALENDAR_BAR_WIDTH + 2, y,
-                                     bounds.size.w - CALENDAR_BAR_WIDTH - 6,
-                                     CALENDAR_ROW_HEIGHT),
-                               GTextOverflowModeTrailingEllipsis,
-                               GTextAlignmentLeft, NULL);
+    for (uint8_t row_index=0; row_index<g_calendar_row_count; row_index++) {
+        int16_t y = row_index*CALENDAR_ROW_HEIGHT;
+        if (y + CALENDAR_ROW_HEIGHT > bounds.size.h) { break; }
+        const CalendarRow* row = &g_calendar_rows[row_index];
+        if (row->length == 0) { continue; }
+
+        graphics_context_set_fill_color(ctx,
+                                        calendar_color(g_calendar_color_array[row_index]));
+        int16_t bar_y = y + CALENDAR_BAR_Y_OFFSET;
+        int16_t bar_height = min(CALENDAR_BAR_HEIGHT, bounds.size.h - bar_y);
+        if (bar_height > 0) {
+            graphics_fill_rect(ctx, GRect(2, bar_y, CALENDAR_BAR_WIDTH,
+                                          bar_height),
+                               0, GCornerNone);
         }
-
-        cursor += line_len;
-        if (*cursor == '\n') { cursor++; }
-        y += CALENDAR_ROW_HEIGHT;
-        row_index++;
+        graphics_context_set_text_color(ctx, GColorWhite);
+        graphics_draw_text(ctx, g_calendar_string + row->offset,
+                           g_font_gothic_14,
+                           GRect(2 + CALENDAR_BAR_WIDTH + 2, y,
+                                 bounds.size.w - CALENDAR_BAR_WIDTH - 6,
+                                 CALENDAR_ROW_HEIGHT),
+                           GTextOverflowModeTrailingEllipsis,
+                           GTextAlignmentLeft, NULL);
     }
 }
 
+// Profiled wrappers for the update procs, see profile.h. Without
+// WATCHFACE_PROFILE these declare nothing and PROFILED(proc) is proc.
+enum ProfileSlot {
+    PROFILE_SLOT_CALENDAR,
+    PROFILE_SLOT_BATTERY,
+    PROFILE_SLOT_CONNECTION,
+    PROFILE_SLOT_WEATHER_ICON,
+    PROFILE_SLOT_WEATHER_TEMP,
+    PROFILE_SLOT_WEATHER_DAY_GRAPH,
+    PROFILE_SLOT_WEATHER_PRECIPGRAPH,
+    PROFILE_SLOT_WEATHER_DETAIL,
+    PROFILE_SLOT_HEALTH_BPM_GRAPH,
+    PROFILE_SLOT_HEALTH_BPM_HEART
+};
+PROFILED_UPDATE_PROC(PROFILE_SLOT_CALENDAR, on_calendar_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_BATTERY, on_battery_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_CONNECTION, on_connection_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_WEATHER_ICON, on_weather_icon_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_WEATHER_TEMP, on_weather_temp_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_WEATHER_DAY_GRAPH, on_weather_day_graph_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_WEATHER_PRECIPGRAPH, on_weather_precipgraph_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_WEATHER_DETAIL, on_weather_detail_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_HEALTH_BPM_GRAPH, on_health_bpm_graph_layer_update)
+PROFILED_UPDATE_PROC(PROFILE_SLOT_HEALTH_BPM_HEART, on_health_bpm_heart_layer_update)
+
 // --------------------------------------------------------------------------
 // System event handlers.
 // --------------------------------------------------------------------------
 
+static bool send_refresh_request(uint8_t sources) {
+    DictionaryIterator* iter;
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {return false;}
+    dict_write_uint8(iter, REFRESH_REQUEST_KEY, sources);
+    if (app_message_outbox_send() != APP_MSG_OK) {return false;}
+    g_refresh_request_time = time(NULL);
+    return true;
+}
+
+// Sources whose graphs are about to run out of samples. The phone refreshes
+// well before this while it can reach the network, so these only fire when
+// its schedule has fallen behind.
+static uint8_t stale_refresh_sources(time_t now) {
+    uint8_t sources = 0;
+    const TimeSeries* precip = &g_weather_precip_series;
+    // A dry series draws nothing, so only rain is worth asking about.
+    if (precip->base_time != 0 &&
+        time_series_offset(precip, now) + WEATHER_PRECIP_GRAPH_INNER_WIDTH > precip->length &&
+        time_series_has_values(precip, 0, precip->length)) {
+        sources |= REFRESH_PRECIPITATION;
+    }
+    const TimeSeries* day = &g_weather_day_atemp_series;
+    if (day->base_time != 0 &&
+        time_series_offset(day, now) + WEATHER_DAY_GRAPH_REFRESH_AHEAD > day->length) {
+        sources |= REFRESH_WEATHER;
+    }
+    return sources;
+}
+
+static void request_stale_refresh(void) {
+    time_t now = time(NULL);
+    if (!g_connected || now - g_refresh_request_time < REFRESH_REQUEST_INTERVAL) {return;}
+    uint8_t sources = stale_refresh_sources(now);
+    if (sources) {
+        send_refresh_request(sources);
+    }
+}
+
 static void on_tick_timer(struct tm* tick_time, TimeUnits units_changed) {
     g_local_time = *tick_time;
-    g_ticks_since_weather_array_update += 1;
-    g_ticks_since_weather_day_graph_update += 1;
     static char time_string[6];
     static char date_string[7];
     strftime(time_string, sizeof time_string, "%H:%M", &g_local_time);
     text_layer_set_text(g_time_layer, time_string);
-    strftime(date_string, sizeof date_string, "%b %d", &g_local_time);
-    text_layer_set_text(g_date_layer, date_string);
-    layer_mark_dirty(g_health_bpm_graph_layer);
-    layer_mark_dirty(g_weather_precipgraph_layer);
-    layer_mark_dirty(g_weather_detail_layer);
-    layer_mark_dirty(g_weather_day_graph_layer);
+    if (units_changed & DAY_UNIT) {
+        strftime(date_string, sizeof date_string, "%b %d", &g_local_time);
+        text_layer_set_text(g_date_layer, date_string);
+    }
+    if (health_bpm_history_append()) {
+        layer_mark_dirty(g_health_bpm_graph_layer);
+    }
+    mark_dirty_if_changed(g_weather_precipgraph_layer,
+                          &g_precipgraph_fingerprint,
+                          weather_precipgraph_fingerprint());
+    mark_dirty_if_changed(g_weather_detail_layer,
+                          &g_weather_detail_fingerprint,
+                          weather_short_precipgraph_visible());
+    mark_dirty_if_changed(g_weather_day_graph_layer,
+                          &g_weather_day_graph_fingerprint,
+                          weather_day_graph_offset());
+    request_stale_refresh();
+    if (tick_time->tm_min % PROFILE_DUMP_INTERVAL_MINUTES == 0) {
+        profile_dump();
+    }
 }
 
 static void on_battery_state(BatteryChargeState state) {
@@ -553,6 +676,11 @@ static void on_battery_state(BatteryChargeState state) {
 static void on_connection(bool connected) {
     g_connected = connected ? 1 : 0; // TODO weird data type conversion
     layer_mark_dirty(g_connection_layer);
+    // Only called on changes, so this is a reconnect, and anything the
+    // phone sent in between was lost.
+    if (connected) {
+        send_refresh_request(REFRESH_ALL);
+    }
 }
 
 static void on_health_heartrate() {
@@ -595,148 +723,484 @@ static void on_health(const HealthEventType event, void* context) {
 
 static void on_tap(AccelAxisType axis, int32_t direction) {
     APP_LOG(APP_LOG_LEVEL_DEBUG, "tap: %d %d", axis, direction);
+    profile_dump();
 }
 
-static void on_sync_error(DictionaryResult dict_error, AppMessageResult app_message_error, void *context) {
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Dict Error: %d; App Message Sync Error: %d", dict_error, app_message_error);
+// Tell the phone we hold none of its data, so its delta sync resends
+// everything instead of skipping values it believes are already here.
+static void send_watch_status(uint8_t status) {
+    DictionaryIterator* iter;
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {return;}
+    dict_write_uint8(iter, WATCH_STATUS_KEY, status);
+    app_message_outbox_send();
 }
 
-static void on_sync_tuple_change(const uint32_t key, const Tuple* new_tuple, const Tuple* old_tuple, void* context) {
+static void on_inbox_dropped(AppMessageResult reason, void* context) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "App Message Dropped: %d", reason);
+}
+
+static void weather_set_icon(uint8_t weather_icon) {
+    if (g_weather_icon == weather_icon &&
+        (g_weather_icon_bitmap || !g_weather_icon)) {
+        return;
+    }
+    g_weather_icon = weather_icon;
+    weather_icon_bitmap_update();
+    layer_mark_dirty(g_weather_icon_layer);
+}
+
+static void weather_set_precipprob(uint8_t precipprob) {
+    static char precipprob_string[5];
+    g_precipprob = precipprob;
+    if (g_precipprob > 0) {
+        snprintf(precipprob_string, sizeof precipprob_string, "%d%%", g_precipprob);
+        text_layer_set_text(g_weather_precipprob_layer, precipprob_string);
+    } else {
+        text_layer_set_text(g_weather_precipprob_layer, "");
+    }
+    layer_mark_dirty(g_weather_detail_layer);
+}
+
+static void weather_set_humidity(uint8_t humidity) {
     static char humidity_string[8];
+    g_weather_humidity = humidity;
+    if (humidity < 101) {
+        snprintf(humidity_string, sizeof humidity_string, "%d%%rh", humidity);
+        text_layer_set_text(g_weather_humidity_layer, humidity_string);
+    }
+}
+
+static void weather_set_wind_speed(uint16_t wind_speed) {
     static char wind_string[8];
-    static char precipprob_string[5];
+    g_weather_wind_speed = wind_speed;
+    if (wind_speed/10 < 100) {
+        snprintf(wind_string, sizeof wind_string, "%dm/s", wind_speed/10);
+        text_layer_set_text(g_weather_wind_layer, wind_string);
+    }
+}
+
+// Formats value into text and lays it out in box, unless text already shows
+// it. Returns whether anything changed.
+static bool weather_text_set(WeatherText* text, bool known, int16_t value,
+                             GRect box, GTextAlignment alignment,
+                             GColor color) {
+    if (!known) { value = WEATHER_TEXT_NONE; }
+    if (text->value == value) { return false; }
+    text->value = value;
+    if (!known) { return true; }
+
+    snprintf(text->text, sizeof text->text, "%d", value);
+    GSize size = graphics_text_layout_get_content_size(
+        text->text, g_font_gothic_14, box, GTextOverflowModeWordWrap, alignment);
+    int16_t x = box.origin.x;
+    if (alignment == GTextAlignmentRight) {
+        x += box.size.w - size.w;
+    } else if (alignment == GTextAlignmentCenter) {
+        x += (box.size.w - size.w)/2;
+    }
+    text->rect = GRect(x, box.origin.y, size.w, box.size.h);
+    text->color = color;
+    return true;
+}
+
+static bool weather_text_set_temp(uint8_t slot, int8_t temp, GRect box,
+                                  GTextAlignment alignment, GColor color) {
+    return weather_text_set(&g_weather_texts[slot],
+                            weather_temp_is_known(temp), temp,
+                            box, alignment, color);
+}
+
+// The max/min columns move left to make room for a minus sign.
+static void weather_format_temps(void) {
+    bool changed = false;
+    changed |= weather_text_set_temp(WEATHER_TEXT_TEMP, g_temp,
+                                     GRect(0,7,18,15), GTextAlignmentRight,
+                                     GColorWhite);
+    changed |= weather_text_set_temp(WEATHER_TEXT_TEMPMAX, g_tempmax,
+                                     GRect(16-((g_tempmax<0)?5:0),0,18,15),
+                                     GTextAlignmentLeft,
+                                     PBL_IF_COLOR_ELSE(GColorRed, GColorWhite));
+    changed |= weather_text_set_temp(WEATHER_TEXT_TEMPMIN, g_tempmin,
+                                     GRect(16-((g_tempmin<0)?5:0),14,18,15),
+                                     GTextAlignmentLeft,
+                                     PBL_IF_COLOR_ELSE(GColorCyan, GColorWhite));
+    changed |= weather_text_set_temp(WEATHER_TEXT_ATEMP, g_atemp,
+                                     GRect(20,7,18,15), GTextAlignmentRight,
+                                     GColorWhite);
+    changed |= weather_text_set_temp(WEATHER_TEXT_ATEMPMAX, g_atempmax,
+                                     GRect(38-((g_atempmax<0)?5:0),0,18,15),
+                                     GTextAlignmentLeft,
+                                     PBL_IF_COLOR_ELSE(GColorRed, GColorWhite));
+    changed |= weather_text_set_temp(WEATHER_TEXT_ATEMPMIN, g_atempmin,
+                                     GRect(38-((g_atempmin<0)?5:0),14,18,15),
+                                     GTextAlignmentLeft,
+                                     PBL_IF_COLOR_ELSE(GColorCyan, GColorWhite));
+    if (changed) { layer_mark_dirty(g_weather_temp_layer); }
+}
+
+static bool weather_text_set_detail(uint8_t slot, bool known, uint8_t value,
+                                    uint8_t cell_index, GColor color) {
+    GRect cell = weather_detail_cell(layer_get_bounds(g_weather_detail_layer),
+                                     cell_index);
+    return weather_text_set(&g_weather_texts[slot], known, value,
+                            GRect(cell.origin.x, 2, cell.size.w, 15),
+                            GTextAlignmentCenter, color);
+}
+
+static void weather_format_details(void) {
+    bool changed = false;
+    changed |= weather_text_set_detail(WEATHER_TEXT_UV,
+                                       g_weather_uv_index != WEATHER_DETAIL_UNKNOWN,
+                                       g_weather_uv_index, 0,
+                                       weather_uv_color(g_weather_uv_index));
+    changed |= weather_text_set_detail(WEATHER_TEXT_CLOUD_COVER,
+                                       g_weather_cloud_cover < WEATHER_PERCENT_UNKNOWN,
+                                       g_weather_cloud_cover, 1, GColorWhite);
+    changed |= weather_text_set_detail(WEATHER_TEXT_VISIBILITY,
+                                       g_weather_visibility_km != WEATHER_DETAIL_UNKNOWN,
+                                       g_weather_visibility_km, 2,
+                                       weather_visibility_color(g_weather_visibility_km));
+    if (changed) { layer_mark_dirty(g_weather_detail_layer); }
+}
+
+// Packed weather record sent by sendWeatherRecord() in index.js under
+// WEATHER_RECORD_KEY. Little-endian: version and flags, then only the groups
+// whose WEATHER_RECORD_HAS_* flag is set, in flag order, so unchanged groups
+// cost no airtime.
+#define WEATHER_RECORD_VERSION 2
+#define WEATHER_RECORD_HAS_CURRENT 0x01
+#define WEATHER_RECORD_HAS_BOUNDS 0x02
+#define WEATHER_RECORD_HAS_PRECIP_PROB 0x04
+#define WEATHER_RECORD_HAS_PRECIP_ARRAY 0x08
+#define WEATHER_RECORD_HAS_DAY_GRAPH 0x10
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t version;
+    uint8_t flags;
+} WeatherRecordHeader;
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t icon;
+    int8_t atemp;
+    int8_t temp;
+    uint8_t humidity;
+    uint16_t wind_speed;
+    uint8_t uv_index;
+    uint8_t cloud_cover;
+    uint8_t visibility_km;
+} WeatherRecordCurrent;
+
+typedef struct __attribute__((__packed__)) {
+    int8_t atempmax;
+    int8_t atempmin;
+    int8_t tempmax;
+    int8_t tempmin;
+} WeatherRecordBounds;
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t day_atemp_array[WEATHER_DAY_GRAPH_SAMPLES];
+    uint8_t day_precip_array[WEATHER_DAY_GRAPH_SAMPLES];
+} WeatherRecordDayGraph;
+
+#define WEATHER_RECORD_MAX_LENGTH (sizeof(WeatherRecordHeader) + \
+                                   sizeof(WeatherRecordCurrent) + \
+                                   sizeof(WeatherRecordBounds) + 1 + \
+                                   WEATHER_PRECIP_SAMPLES + \
+                                   sizeof(WeatherRecordDayGraph))
+
+static uint16_t weather_record_length(uint8_t flags) {
+    uint16_t length = sizeof(WeatherRecordHeader);
+    if (flags & WEATHER_RECORD_HAS_CURRENT) {length += sizeof(WeatherRecordCurrent);}
+    if (flags & WEATHER_RECORD_HAS_BOUNDS) {length += sizeof(WeatherRecordBounds);}
+    if (flags & WEATHER_RECORD_HAS_PRECIP_PROB) {length += 1;}
+    if (flags & WEATHER_RECORD_HAS_PRECIP_ARRAY) {length += WEATHER_PRECIP_SAMPLES;}
+    if (flags & WEATHER_RECORD_HAS_DAY_GRAPH) {length += sizeof(WeatherRecordDayGraph);}
+    return length;
+}
+
+// Reads the record in place, straight out of the inbox or the persisted
+// copy; the packed layouts make that safe at any alignment.
+static void weather_apply_record(const uint8_t* data, uint16_t length) {
+    if (length < sizeof(WeatherRecordHeader)) {return;}
+    const WeatherRecordHeader* header = (const WeatherRecordHeader*)data;
+    if (header->version != WEATHER_RECORD_VERSION ||
+        length < weather_record_length(header->flags)) {return;}
+    uint8_t flags = header->flags;
+    const uint8_t* group = data + sizeof(*header);
+    g_weather_record_flags |= flags;
+
+    if (flags & WEATHER_RECORD_HAS_CURRENT) {
+        const WeatherRecordCurrent* current = (const WeatherRecordCurrent*)group;
+        weather_set_icon(current->icon);
+        g_atemp = current->atemp;
+        g_temp = current->temp;
+        weather_set_humidity(current->humidity);
+        weather_set_wind_speed(current->wind_speed);
+        g_weather_uv_index = current->uv_index;
+        g_weather_cloud_cover = current->cloud_cover;
+        g_weather_visibility_km = current->visibility_km;
+        weather_format_temps();
+        weather_format_details();
+        group += sizeof(*current);
+    }
+    if (flags & WEATHER_RECORD_HAS_BOUNDS) {
+        const WeatherRecordBounds* bounds = (const WeatherRecordBounds*)group;
+        g_atempmax = bounds->atempmax;
+        g_atempmin = bounds->atempmin;
+        g_tempmax = bounds->tempmax;
+        g_tempmin = bounds->tempmin;
+        weather_format_temps();
+        group += sizeof(*bounds);
+    }
+    if (flags & WEATHER_RECORD_HAS_PRECIP_PROB) {
+        weather_set_precipprob(*group);
+        group += 1;
+    }
+    if (flags & WEATHER_RECORD_HAS_PRECIP_ARRAY) {
+        time_series_set(&g_weather_precip_series, group, time(NULL));
+        layer_mark_dirty(g_weather_precipgraph_layer);
+        layer_mark_dirty(g_weather_detail_layer);
+        group += WEATHER_PRECIP_SAMPLES;
+    }
+    if (flags & WEATHER_RECORD_HAS_DAY_GRAPH) {
+        const WeatherRecordDayGraph* day_graph = (const WeatherRecordDayGraph*)group;
+        time_t now = time(NULL);
+        time_series_set(&g_weather_day_atemp_series, day_graph->day_atemp_array, now);
+        time_series_set(&g_weather_day_precip_series, day_graph->day_precip_array, now);
+        layer_mark_dirty(g_weather_day_graph_layer);
+    }
+}
+
+// Inverse of weather_apply_record for the groups received so far. data
+// holds WEATHER_RECORD_MAX_LENGTH bytes; returns the length used.
+static uint16_t weather_build_record(uint8_t* data) {
+    uint8_t flags = g_weather_record_flags;
+    *(WeatherRecordHeader*)data = (WeatherRecordHeader){
+        .version = WEATHER_RECORD_VERSION,
+        .flags = flags
+    };
+    uint8_t* group = data + sizeof(WeatherRecordHeader);
+
+    if (flags & WEATHER_RECORD_HAS_CURRENT) {
+        *(WeatherRecordCurrent*)group = (WeatherRecordCurrent){
+            .icon = g_weather_icon,
+            .atemp = g_atemp,
+            .temp = g_temp,
+            .humidity = g_weather_humidity,
+            .wind_speed = g_weather_wind_speed,
+            .uv_index = g_weather_uv_index,
+            .cloud_cover = g_weather_cloud_cover,
+            .visibility_km = g_weather_visibility_km
+        };
+        group += sizeof(WeatherRecordCurrent);
+    }
+    if (flags & WEATHER_RECORD_HAS_BOUNDS) {
+        *(WeatherRecordBounds*)group = (WeatherRecordBounds){
+            .atempmax = g_atempmax,
+            .atempmin = g_atempmin,
+            .tempmax = g_tempmax,
+            .tempmin = g_tempmin
+        };
+        group += sizeof(WeatherRecordBounds);
+    }
+    if (flags & WEATHER_RECORD_HAS_PRECIP_PROB) {
+        *group++ = g_precipprob;
+    }
+    if (flags & WEATHER_RECORD_HAS_PRECIP_ARRAY) {
+        memcpy(group, g_weather_precip_array, WEATHER_PRECIP_SAMPLES);
+        group += WEATHER_PRECIP_SAMPLES;
+    }
+    if (flags & WEATHER_RECORD_HAS_DAY_GRAPH) {
+        WeatherRecordDayGraph* day_graph = (WeatherRecordDayGraph*)group;
+        memcpy(day_graph->day_atemp_array, g_weather_day_atemp_array,
+               sizeof(day_graph->day_atemp_array));
+        memcpy(day_graph->day_precip_array, g_weather_day_precip_array,
+               sizeof(day_graph->day_precip_array));
+        group += sizeof(*day_graph);
+    }
+    return group - data;
+}
+
+static void report_set_text(const char* text, uint16_t length) {
+    length = min(length, sizeof(g_report_string) - 1);
+    memcpy(g_report_string, text, length);
+    g_report_string[length] = '\0';
+    text_layer_set_text(g_report_layer, g_report_string);
+}
+
+// Split the calendar text into rows once, on arrival. Rows are separated by
+// '\n' as sent by the phone, or by NUL in the persisted copy.
+static void calendar_set_text(const char* text, uint16_t length) {
+    length = min(length, sizeof(g_calendar_string) - 1);
+    memcpy(g_calendar_string, text, length);
+    g_calendar_string[length] = '\0';
+    g_calendar_length = length;
+    g_calendar_row_count = 0;
+
+    uint16_t start = 0;
+    for (uint16_t i=0; i<=length && g_calendar_row_count<CALENDAR_ENTRY_COUNT; i++) {
+        char ch = g_calendar_string[i];
+        if (ch != '\n' && ch != '\0') { continue; }
+        if (i == length && start == length) { break; }
+        g_calendar_string[i] = '\0';
+        g_calendar_rows[g_calendar_row_count++] = (CalendarRow){
+            .offset = start, .length = i - start
+        };
+        start = i + 1;
+    }
+    layer_mark_dirty(g_calendar_layer);
+}
+
+static void calendar_set_colors(const uint8_t* data, uint16_t length) {
+    for (int i=0; i<CALENDAR_ENTRY_COUNT; i++) {
+        g_calendar_color_array[i] = 0;
+    }
+    int copy_len = min(length, sizeof(g_calendar_color_array));
+    if (copy_len > 0) {
+        memcpy(g_calendar_color_array, data, copy_len);
+    }
+    layer_mark_dirty(g_calendar_layer);
+}
+
+// Strings arrive NUL-terminated in a single message and without the
+// terminator through a transfer, so the setters take an explicit length.
+static uint16_t message_text_length(const uint8_t* data, uint16_t length) {
+    uint16_t text_length = 0;
+    while (text_length < length && data[text_length]) { text_length++; }
+    return text_length;
+}
+
+static void apply_message_value(uint32_t key, const uint8_t* data,
+                                uint16_t length) {
     switch (key) {
-        case WEATHER_ICON_KEY:
-            g_weather_icon = new_tuple->value->uint8;
-            layer_mark_dirty(g_weather_icon_layer);
-            break;
-        case WEATHER_ATEMPERATURE_KEY:
-            g_atemp = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_ATEMPERATUREMAX_KEY:
-            g_atempmax = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_ATEMPERATUREMIN_KEY:
-            g_atempmin = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_TEMPERATURE_KEY:
-            g_temp = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_TEMPERATUREMAX_KEY:
-            g_tempmax = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_TEMPERATUREMIN_KEY:
-            g_tempmin = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_PRECIP_PROB_KEY:
-            g_precipprob = new_tuple->value->uint8;
-            if (g_precipprob > 0) {
-                snprintf(precipprob_string, sizeof precipprob_string, "%d%%", g_precipprob);
-                text_layer_set_text(g_weather_precipprob_layer, precipprob_string);
-            } else {
-                text_layer_set_text(g_weather_precipprob_layer, "");
-            }
-            layer_mark_dirty(g_weather_detail_layer);
-            break;
-        case WEATHER_PRECIP_ARRAY_KEY: {
-            for (int i=0; i<(int)sizeof(g_weather_precip_array); i++) {
-                g_weather_precip_array[i] = 0;
-            }
-            int copy_len = min(new_tuple->length, sizeof(g_weather_precip_array));
-            if (copy_len > 0) {
-                memcpy(g_weather_precip_array, new_tuple->value->data, copy_len);
-            }
-            g_ticks_since_weather_array_update = 0;
-            layer_mark_dirty(g_weather_precipgraph_layer);
-            layer_mark_dirty(g_weather_detail_layer);
-            break;
-        }
-        case WEATHER_HUMIDITY_KEY:
-            if (new_tuple->value->uint8 < 101) {
-                snprintf(humidity_string, sizeof humidity_string, "%d%%rh", new_tuple->value->uint8);
-                text_layer_set_text(g_weather_humidity_layer, humidity_string);
-            }
-            break;
-        case WEATHER_WIND_SPEED_KEY:
-            if (new_tuple->value->uint16/10 < 100) {
-                snprintf(wind_string, sizeof wind_string, "%dm/s", new_tuple->value->uint16/10); 
-                text_layer_set_text(g_weather_wind_layer, wind_string);
-            }
+        case WEATHER_RECORD_KEY:
+            weather_apply_record(data, length);
             break;
         case REPORT_KEY:
-            strncpy(g_report_string, new_tuple->value->cstring, sizeof(g_report_string) - 1);
-            g_report_string[sizeof(g_report_string) - 1] = '\0';
-            text_layer_set_text(g_report_layer, g_report_string);
+            report_set_text((const char*)data, message_text_length(data, length));
             break;
         case CALENDAR_KEY:
-            strncpy(g_calendar_string, new_tuple->value->cstring, sizeof(g_calendar_string) - 1);
-            g_calendar_string[sizeof(g_calendar_string) - 1] = '\0';
-            layer_mark_dirty(g_calendar_layer);
-            break;
-        case CALENDAR_COLORS_KEY: {
-            for (int i=0; i<CALENDAR_ENTRY_COUNT; i++) {
-                g_calendar_color_array[i] = 0;
-            }
-            int copy_len = min(new_tuple->length, sizeof(g_calendar_color_array));
-            if (copy_len > 0) {
-                memcpy(g_calendar_color_array, new_tuple->value->data, copy_len);
-            }
-            layer_mark_dirty(g_calendar_layer);
-            break;
-        }
-        case WEATHER_DAY_ATEMP_ARRAY_KEY: {
-            for (int i=0; i<WEATHER_DAY_GRAPH_SAMPLES; i++) {
-                g_weather_day_atemp_array[i] = WEATHER_DAY_GRAPH_UNKNOWN;
-            }
-            int copy_len = min(new_tuple->length, sizeof(g_weather_day_atemp_array));
-            if (copy_len > 0) {
-                memcpy(g_weather_day_atemp_array, new_tuple->value->data, copy_len);
-            }
-            g_ticks_since_weather_day_graph_update = 0;
-            layer_mark_dirty(g_weather_day_graph_layer);
+            calendar_set_text((const char*)data, message_text_length(data, length));
             break;
-        }
-        case WEATHER_DAY_PRECIP_ARRAY_KEY: {
-            for (int i=0; i<WEATHER_DAY_GRAPH_SAMPLES; i++) {
-                g_weather_day_precip_array[i] = WEATHER_DAY_GRAPH_UNKNOWN;
-            }
-            int copy_len = min(new_tuple->length, sizeof(g_weather_day_precip_array));
-            if (copy_len > 0) {
-                memcpy(g_weather_day_precip_array, new_tuple->value->data, copy_len);
-            }
-            g_ticks_since_weather_day_graph_update = 0;
-            layer_mark_dirty(g_weather_day_graph_layer);
-            break;
-        }
-        case WEATHER_UV_INDEX_KEY:
-            g_weather_uv_index = new_tuple->value->uint8;
-            layer_mark_dirty(g_weather_detail_layer);
-            break;
-        case WEATHER_CLOUD_COVER_KEY:
-            g_weather_cloud_cover = new_tuple->value->uint8;
-            layer_mark_dirty(g_weather_detail_layer);
-            break;
-        case WEATHER_VISIBILITY_KEY:
-            g_weather_visibility_km = new_tuple->value->uint8;
-            layer_mark_dirty(g_weather_detail_layer);
+        case CALENDAR_COLORS_KEY:
+            calendar_set_colors(data, length);
             break;
         default:
             break;
     }
 }
 
+// Each tuple is handed to its setter while it is still in the inbox, so
+// values are copied once, into the storage the watchface draws from.
+static void on_inbox_received(DictionaryIterator* iterator, void* context) {
+    for (Tuple* tuple=dict_read_first(iterator); tuple; tuple=dict_read_next(iterator)) {
+        if (tuple->key == TRANSFER_CHUNK_KEY) {
+            transfer_receive_chunk(&g_transfer, tuple->value->data, tuple->length);
+        } else {
+            apply_message_value(tuple->key, tuple->value->data, tuple->length);
+        }
+    }
+    profile_memory_log("inbox");
+}
+
+// --------------------------------------------------------------------------
+// Persisted state, so a restart shows the last data before the phone answers.
+// --------------------------------------------------------------------------
+
+#define PERSIST_VERSION 2
+
+enum PersistKey {
+  PERSIST_VERSION_KEY = 1,
+  PERSIST_WEATHER_KEY = 2,
+  PERSIST_REPORT_KEY = 3,
+  PERSIST_CALENDAR_KEY = 4,
+  PERSIST_CALENDAR_COLORS_KEY = 5
+};
+
+typedef struct __attribute__((__packed__)) {
+    uint32_t precip_array_time;
+    uint32_t day_graph_time;
+    uint8_t record[WEATHER_RECORD_MAX_LENGTH]; // Only the groups received.
+} PersistedWeather;
+
+static void persist_save_state(void) {
+    PersistedWeather weather = {
+        .precip_array_time = (uint32_t)g_weather_precip_series.base_time,
+        .day_graph_time = (uint32_t)g_weather_day_atemp_series.base_time
+    };
+    uint16_t record_length = weather_build_record(weather.record);
+
+    persist_write_int(PERSIST_VERSION_KEY, PERSIST_VERSION);
+    persist_write_data(PERSIST_WEATHER_KEY, &weather,
+                       offsetof(PersistedWeather, record) + record_length);
+    // Texts longer than one persist value are cut; the phone resends the
+    // whole text after a restart anyway.
+    persist_write_data(PERSIST_REPORT_KEY, g_report_string,
+                       min(strlen(g_report_string) + 1, PERSIST_DATA_MAX_LENGTH));
+    persist_write_data(PERSIST_CALENDAR_KEY, g_calendar_string,
+                       min(g_calendar_length + 1, PERSIST_DATA_MAX_LENGTH));
+    persist_write_data(PERSIST_CALENDAR_COLORS_KEY, g_calendar_color_array,
+                       sizeof(g_calendar_color_array));
+}
+
+static void persist_restore_state(void) {
+    if (persist_read_int(PERSIST_VERSION_KEY) != PERSIST_VERSION) {return;}
+
+    PersistedWeather weather;
+    int weather_length = persist_read_data(PERSIST_WEATHER_KEY, &weather,
+                                           sizeof(weather));
+    if (weather_length > (int)offsetof(PersistedWeather, record)) {
+        weather_apply_record(weather.record,
+                             weather_length - offsetof(PersistedWeather, record));
+        // Put the series back on the time axis they arrived on.
+        time_series_set_base_time(&g_weather_precip_series,
+                                  weather.precip_array_time);
+        time_series_set_base_time(&g_weather_day_atemp_series,
+                                  weather.day_graph_time);
+        time_series_set_base_time(&g_weather_day_precip_series,
+                                  weather.day_graph_time);
+    }
+
+    // Both texts end in the terminator persist_save_state wrote, or in the
+    // last byte that fitted; either way it is dropped.
+    char text[PERSIST_DATA_MAX_LENGTH];
+    int report_length = persist_read_data(PERSIST_REPORT_KEY, text, sizeof(text));
+    if (report_length > 0) {
+        report_set_text(text, report_length - 1);
+    }
+    int calendar_length = persist_read_data(PERSIST_CALENDAR_KEY, text, sizeof(text));
+    if (calendar_length > 0) {
+        calendar_set_text(text, calendar_length - 1);
+    }
+    uint8_t colors[CALENDAR_ENTRY_COUNT];
+    int colors_length = persist_read_data(PERSIST_CALENDAR_COLORS_KEY, colors,
+                                          sizeof(colors));
+    if (colors_length > 0) {
+        calendar_set_colors(colors, colors_length);
+    }
+}
+
 
 // --------------------------------------------------------------------------
 // Initialization and teardown.
 // --------------------------------------------------------------------------
 
 static void init() {
+    profile_memory_start();
+    g_font_gothic_14 = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+    for (int i=0; i<WEATHER_TEXT_COUNT; i++) {
+        g_weather_texts[i].value = WEATHER_TEXT_NONE;
+    }
+    time_series_init(&g_weather_precip_series, g_weather_precip_array,
+                     &g_weather_precip_summary, WEATHER_PRECIP_SAMPLES,
+                     WEATHER_PRECIP_STEP, 0);
+    time_series_init(&g_weather_day_atemp_series, g_weather_day_atemp_array,
+                     &g_weather_day_atemp_summary, WEATHER_DAY_GRAPH_SAMPLES,
+                     WEATHER_DAY_GRAPH_STEP, WEATHER_DAY_GRAPH_UNKNOWN);
+    time_series_init(&g_weather_day_precip_series, g_weather_day_precip_array,
+                     &g_weather_day_precip_summary, WEATHER_DAY_GRAPH_SAMPLES,
+                     WEATHER_DAY_GRAPH_STEP, WEATHER_DAY_GRAPH_UNKNOWN);
+
     g_window = window_create();
     window_stack_push(g_window, true);
     window_set_background_color(g_window, GColorBlack);
@@ -763,7 +1227,7 @@ static void init() {
     layer_add_child(window_layer, text_layer_get_layer(g_report_layer));
     text_layer_set_background_color(g_report_layer, GColorBlack);
     text_layer_set_text_color(g_report_layer, GColorWhite);
-    text_layer_set_font(g_report_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+    text_layer_set_font(g_report_layer, g_font_gothic_14);
     text_layer_set_text_alignment(g_report_layer, GTextAlignmentLeft);
     text_layer_set_overflow_mode(g_report_layer, GTextOverflowModeWordWrap);
 
@@ -771,26 +1235,28 @@ static void init() {
                                           CALENDAR_DATA_Y,
                                           bounds.size.w/2-2,
                                           CALENDAR_DATA_HEIGHT));
-    layer_set_update_proc(g_calendar_layer, &on_calendar_layer_update);
+    layer_set_update_proc(g_calendar_layer, PROFILED(on_calendar_layer_update));
     layer_add_child(window_layer, g_calendar_layer);
     
     g_battery_layer = layer_create(GRect(1, 1, 10, 17));
-    layer_set_update_proc(g_battery_layer, &on_battery_layer_update);
+    layer_set_update_proc(g_battery_layer, PROFILED(on_battery_layer_update));
     layer_add_child(window_layer, g_battery_layer);
 
     g_connection_layer = layer_create(GRect(15, 3, 7, 13));
-    layer_set_update_proc(g_connection_layer, &on_connection_layer_update);
+    layer_set_update_proc(g_connection_layer, PROFILED(on_connection_layer_update));
     layer_add_child(window_layer, g_connection_layer);
 
     
     // Weather
-    g_weather_icon_layer = layer_create(GRect(1, bounds.size.h-27, 25, 25));
-    layer_set_update_proc(g_weather_icon_layer, &on_weather_icon_layer_update);
+    g_weather_icon_atlas = gbitmap_create_with_resource(RESOURCE_ID_Weather_Atlas_25);
+    g_weather_icon_layer = layer_create(GRect(1, bounds.size.h-27,
+                                              WEATHER_ICON_SIZE, WEATHER_ICON_SIZE));
+    layer_set_update_proc(g_weather_icon_layer, PROFILED(on_weather_icon_layer_update));
     layer_add_child(window_layer, g_weather_icon_layer);
 
     GRect weather_temp_frame = GRect(27, bounds.size.h-30, 54, 30);
     g_weather_temp_layer = layer_create(weather_temp_frame);
-    layer_set_update_proc(g_weather_temp_layer, &on_weather_temp_layer_update);
+    layer_set_update_proc(g_weather_temp_layer, PROFILED(on_weather_temp_layer_update));
     layer_add_child(window_layer, g_weather_temp_layer);
 
     GRect weather_day_graph_frame = GRect(weather_temp_frame.origin.x+weather_temp_frame.size.w+1,
@@ -798,7 +1264,7 @@ static void init() {
                                           WEATHER_DAY_GRAPH_SAMPLES+2,
                                           27);
     g_weather_day_graph_layer = layer_create(weather_day_graph_frame);
-    layer_set_update_proc(g_weather_day_graph_layer, &on_weather_day_graph_layer_update);
+    layer_set_update_proc(g_weather_day_graph_layer, PROFILED(on_weather_day_graph_layer_update));
     layer_add_child(window_layer, g_weather_day_graph_layer);
 
     GRect weather_precipgraph_frame = GRect(bounds.size.w-50, bounds.size.h-27, 49, 27);
@@ -807,7 +1273,7 @@ static void init() {
         weather_precipgraph_frame.origin.x;
     
     g_weather_precipgraph_layer = layer_create(weather_precipgraph_frame);
-    layer_set_update_proc(g_weather_precipgraph_layer, &on_weather_precipgraph_layer_update);
+    layer_set_update_proc(g_weather_precipgraph_layer, PROFILED(on_weather_precipgraph_layer_update));
     if (g_show_short_precipgraph) {
         layer_add_child(window_layer, g_weather_precipgraph_layer);
     }
@@ -817,65 +1283,76 @@ static void init() {
     GRect weather_detail_frame = GRect(weather_detail_x, bounds.size.h-30,
                                        bounds.size.w-weather_detail_x-1, 30);
     g_weather_detail_layer = layer_create(weather_detail_frame);
-    layer_set_update_proc(g_weather_detail_layer, &on_weather_detail_layer_update);
+    layer_set_update_proc(g_weather_detail_layer, PROFILED(on_weather_detail_layer_update));
     layer_add_child(window_layer, g_weather_detail_layer);
 
     g_weather_humidity_layer = text_layer_create(GRect(1, bounds.size.h-42, 44, 14));
     layer_add_child(window_layer, text_layer_get_layer(g_weather_humidity_layer));
     text_layer_set_background_color(g_weather_humidity_layer, GColorBlack);
     text_layer_set_text_color(g_weather_humidity_layer, GColorWhite);
-    text_layer_set_font(g_weather_humidity_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+    text_layer_set_font(g_weather_humidity_layer, g_font_gothic_14);
 
     g_weather_wind_layer = text_layer_create(GRect(42, bounds.size.h-42, 39, 14));
     layer_add_child(window_layer, text_layer_get_layer(g_weather_wind_layer));
     text_layer_set_background_color(g_weather_wind_layer, GColorBlack);
     text_layer_set_text_color(g_weather_wind_layer, GColorWhite);
-    text_layer_set_font(g_weather_wind_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+    text_layer_set_font(g_weather_wind_layer, g_font_gothic_14);
 
     g_weather_precipprob_layer = text_layer_create(GRect(82, bounds.size.h-42, 30, 14));
     layer_add_child(window_layer, text_layer_get_layer(g_weather_precipprob_layer));
     text_layer_set_background_color(g_weather_precipprob_layer, GColorBlack);
     text_layer_set_text_color(g_weather_precipprob_layer, PBL_IF_COLOR_ELSE(GColorCyan, GColorWhite));
-    text_layer_set_font(g_weather_precipprob_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+    text_layer_set_font(g_weather_precipprob_layer, g_font_gothic_14);
 
     
     // Health
     g_health_bpm_graph_layer = layer_create(GRect(1, bounds.size.h-43-40-22, 34, 22));
-    layer_set_update_proc(g_health_bpm_graph_layer, &on_health_bpm_graph_layer_update);
+    layer_set_update_proc(g_health_bpm_graph_layer, PROFILED(on_health_bpm_graph_layer_update));
     layer_add_child(window_layer, g_health_bpm_graph_layer);
 
     g_health_bpm_heart_layer = layer_create(GRect(1, bounds.size.h-43-40, 9, 14));
-    layer_set_update_proc(g_health_bpm_heart_layer, &on_health_bpm_heart_layer_update);
+    layer_set_update_proc(g_health_bpm_heart_layer, PROFILED(on_health_bpm_heart_layer_update));
     layer_add_child(window_layer, g_health_bpm_heart_layer);
 
     g_health_bpm_text_layer = text_layer_create(GRect(10, bounds.size.h-43-40, 23, 14));
     layer_add_child(window_layer, text_layer_get_layer(g_health_bpm_text_layer));
     text_layer_set_background_color(g_health_bpm_text_layer, GColorBlack);
     text_layer_set_text_color(g_health_bpm_text_layer, PBL_IF_COLOR_ELSE(GColorRed, GColorWhite));
-    text_layer_set_font(g_health_bpm_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+    text_layer_set_font(g_health_bpm_text_layer, g_font_gothic_14);
     
     g_health_meters_text_layer = text_layer_create(GRect(33, bounds.size.h-43-40, 38, 14));
     layer_add_child(window_layer, text_layer_get_layer(g_health_meters_text_layer));
     text_layer_set_background_color(g_health_meters_text_layer, GColorBlack);
     text_layer_set_text_color(g_health_meters_text_layer, GColorWhite);
-    text_layer_set_font(g_health_meters_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+    text_layer_set_font(g_health_meters_text_layer, g_font_gothic_14);
     
     g_health_sleep_text_layer = text_layer_create(GRect(1, bounds.size.h-29-40, 70, 14));
     layer_add_child(window_layer, text_layer_get_layer(g_health_sleep_text_layer));
     text_layer_set_background_color(g_health_sleep_text_layer, GColorBlack);
     text_layer_set_text_color(g_health_sleep_text_layer, GColorWhite);
     text_layer_set_overflow_mode(g_health_sleep_text_layer, GTextOverflowModeWordWrap);
-    text_layer_set_font(g_health_sleep_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+    text_layer_set_font(g_health_sleep_text_layer, g_font_gothic_14);
 
     g_health_cals_text_layer = text_layer_create(GRect(1, bounds.size.h-15-40, 80, 14));
     //layer_add_child(window_layer, text_layer_get_layer(g_health_cals_text_layer)); // TODO calories counted incorrectly
     text_layer_set_background_color(g_health_cals_text_layer, GColorBlack);
     text_layer_set_text_color(g_health_cals_text_layer, GColorWhite);
-    text_layer_set_font(g_health_cals_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-
+    text_layer_set_font(g_health_cals_text_layer, g_font_gothic_14);
+
+    plot_chrome_init(&g_health_bpm_heart_chrome,
+                     layer_get_bounds(g_health_bpm_heart_layer).size,
+                     health_bpm_heart_chrome);
+    plot_chrome_init(&g_weather_day_graph_chrome,
+                     layer_get_bounds(g_weather_day_graph_layer).size,
+                     weather_day_graph_chrome);
+
+    // Seed and restore first, so the initial tick takes its change
+    // fingerprints from the data actually on screen.
+    health_bpm_history_seed();
+    persist_restore_state();
     time_t now = time(NULL);
     g_local_time = *localtime(&now);
-    on_tick_timer(&g_local_time, MINUTE_UNIT);
+    on_tick_timer(&g_local_time, MINUTE_UNIT | DAY_UNIT);
     tick_timer_service_subscribe(MINUTE_UNIT, &on_tick_timer);
   
     battery_state_service_subscribe(&on_battery_state);
@@ -885,44 +1362,27 @@ static void init() {
     on_health(HealthEventHeartRateUpdate, NULL);
 
     connection_service_subscribe((ConnectionHandlers) {.pebble_app_connection_handler = on_connection});
-    on_connection(connection_service_peek_pebble_app_connection());
+    g_connected = connection_service_peek_pebble_app_connection() ? 1 : 0;
   
     accel_tap_service_subscribe(on_tap);  
 
-    for (int i=0; i<WEATHER_DAY_GRAPH_SAMPLES; i++) {
-        g_weather_day_atemp_array[i] = WEATHER_DAY_GRAPH_UNKNOWN;
-        g_weather_day_precip_array[i] = WEATHER_DAY_GRAPH_UNKNOWN;
-    }
-  
-    Tuplet initial_values[] = {
-        TupletInteger(WEATHER_ICON_KEY, (uint8_t)0),
-        TupletInteger(WEATHER_ATEMPERATURE_KEY, WEATHER_TEMP_UNKNOWN),
-        TupletInteger(WEATHER_ATEMPERATUREMAX_KEY, WEATHER_TEMP_UNKNOWN),
-        TupletInteger(WEATHER_ATEMPERATUREMIN_KEY, WEATHER_TEMP_UNKNOWN),
-        TupletInteger(WEATHER_TEMPERATURE_KEY, WEATHER_TEMP_UNKNOWN),
-        TupletInteger(WEATHER_TEMPERATUREMAX_KEY, WEATHER_TEMP_UNKNOWN),
-        TupletInteger(WEATHER_TEMPERATUREMIN_KEY, WEATHER_TEMP_UNKNOWN),
-        TupletInteger(WEATHER_PRECIP_PROB_KEY, (uint8_t)0),
-        TupletBytes(WEATHER_PRECIP_ARRAY_KEY, g_weather_precip_array, sizeof(g_weather_precip_array)),
-        TupletInteger(WEATHER_HUMIDITY_KEY, (uint8_t)101),
-        TupletInteger(WEATHER_WIND_SPEED_KEY, (uint16_t)1001),
-        TupletCString(REPORT_KEY, ""),
-        TupletBytes(WEATHER_DAY_ATEMP_ARRAY_KEY, g_weather_day_atemp_array, sizeof(g_weather_day_atemp_array)),
-        TupletBytes(WEATHER_DAY_PRECIP_ARRAY_KEY, g_weather_day_precip_array, sizeof(g_weather_day_precip_array)),
-        TupletInteger(WEATHER_UV_INDEX_KEY, (uint8_t)WEATHER_DETAIL_UNKNOWN),
-        TupletInteger(WEATHER_CLOUD_COVER_KEY, (uint8_t)WEATHER_PERCENT_UNKNOWN),
-        TupletInteger(WEATHER_VISIBILITY_KEY, (uint8_t)WEATHER_DETAIL_UNKNOWN),
-        TupletCString(CALENDAR_KEY, ""),
-        TupletBytes(CALENDAR_COLORS_KEY, g_calendar_color_array, sizeof(g_calendar_color_array))
-    };
-
-    app_sync_init(&g_sync, g_sync_buffer, sizeof(g_sync_buffer),
-                  initial_values, ARRAY_LENGTH(initial_values),
-                  on_sync_tuple_change, on_sync_error, NULL);
+    transfer_init(&g_transfer, g_transfer_buffer, sizeof(g_transfer_buffer),
+                  TRANSFER_REPLY_KEY, apply_message_value);
+    app_message_register_inbox_received(on_inbox_received);
+    app_message_register_inbox_dropped(on_inbox_dropped);
+    // The inbox and outbox come from the app heap and are freed by the
+    // system only after deinit.
+    profile_memory_retain_begin();
     app_message_open(MESSAGE_BUF, MESSAGE_BUF);
+    profile_memory_retain_end();
+    send_watch_status(WATCH_STATUS_FRESH_START);
+    profile_memory_log("init");
+    profile_stack_start(window_layer);
 }
 
 static void deinit() {
+    profile_dump();
+    persist_save_state();
     tick_timer_service_unsubscribe();
     battery_state_service_unsubscribe();
     health_service_events_unsubscribe();
@@ -933,8 +1393,16 @@ static void deinit() {
     layer_destroy(g_battery_layer);
     layer_destroy(g_connection_layer);
     layer_destroy(g_health_bpm_graph_layer);
+    plot_chrome_deinit(&g_health_bpm_heart_chrome);
+    plot_chrome_deinit(&g_weather_day_graph_chrome);
     layer_destroy(g_weather_temp_layer);
     layer_destroy(g_weather_icon_layer);
+    if (g_weather_icon_bitmap) {
+        gbitmap_destroy(g_weather_icon_bitmap);
+    }
+    if (g_weather_icon_atlas) {
+        gbitmap_destroy(g_weather_icon_atlas);
+    }
     text_layer_destroy(g_weather_precipprob_layer);
     layer_destroy(g_weather_precipgraph_layer);
     layer_destroy(g_weather_detail_layer);
@@ -949,7 +1417,8 @@ static void deinit() {
     text_layer_destroy(g_report_layer);
     layer_destroy(g_calendar_layer);
     window_destroy(g_window);
-    app_sync_deinit(&g_sync);
+    app_message_deregister_callbacks();
+    profile_memory_report_leaks();
 }
 
 // --------------------------------------------------------------------------
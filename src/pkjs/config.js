@@ -34,6 +34,19 @@ module.exports = [
         "messageKey": "ReportSource",
         "defaultValue": "",
         "label": "HTTP address"
+      },
+      {
+        "type": "select",
+        "messageKey": "ReportInterval",
+        "defaultValue": "30",
+        "label": "Refresh every",
+        "options": [
+          { "label": "5 minutes", "value": "5" },
+          { "label": "15 minutes", "value": "15" },
+          { "label": "30 minutes", "value": "30" },
+          { "label": "1 hour", "value": "60" },
+          { "label": "3 hours", "value": "180" }
+        ]
       }
     ]
   },
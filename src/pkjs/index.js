@@ -2,6 +2,7 @@ var OpenWeatherKey = localStorage.getItem("OpenWeatherKey");
 var ReportSource = localStorage.getItem("ReportSource");
 var CalendarUrls = localStorage.getItem("CalendarUrls");
 var CalendarColors = localStorage.getItem("CalendarColors");
+var ReportInterval = localStorage.getItem("ReportInterval"); // Minutes.
 
 var Clay = require('pebble-clay');
 var ICAL = require('ical.js');
@@ -11,12 +12,50 @@ var WEATHER_TEMP_UNKNOWN = -128;
 var REPORT_KEY = 11;
 var CALENDAR_KEY = 17;
 var CALENDAR_COLORS_KEY = 18;
-var REPORT_TEXT_MAX_LENGTH = 219;
-var CALENDAR_TEXT_MAX_LENGTH = 255;
+var WEATHER_RECORD_KEY = 19;
+var WEATHER_RECORD_VERSION = 2;
+var WEATHER_RECORD_HAS_CURRENT = 0x01;
+var WEATHER_RECORD_HAS_BOUNDS = 0x02;
+var WEATHER_RECORD_HAS_PRECIP_PROB = 0x04;
+var WEATHER_RECORD_HAS_PRECIP_ARRAY = 0x08;
+var WEATHER_RECORD_HAS_DAY_GRAPH = 0x10;
+var WEATHER_PRECIP_SAMPLES = 60;
+var WATCH_STATUS_KEY = 20;
+var WATCH_STATUS_FRESH_START = 1;
+var TRANSFER_CHUNK_KEY = 21;
+var TRANSFER_REPLY_KEY = 22;
+var REFRESH_REQUEST_KEY = 23;
+var REFRESH_REQUEST_MIN_AGE = 60*1000; // A source fetched this recently is not fetched again.
+var TRANSFER_CHUNK_SIZE = 512;        // Must match transfer.h.
+var TRANSFER_INLINE_MAX_LENGTH = 600; // Larger values go in chunks.
+var TRANSFER_ACK = 1;
+var TRANSFER_NACK = 2;
+var TRANSFER_REJECT = 3;
+var TRANSFER_REPLY_TIMEOUT = 5000;
+var TRANSFER_MAX_RETRIES = 3;
+var APP_MESSAGE_MAX_ATTEMPTS = 5;
+var APP_MESSAGE_RETRY_DELAY = 1000; // Doubles after every failed attempt.
+var SYNC_SNAPSHOT_STORAGE_KEY = "SyncSnapshot";
+var FRESH_START_REFRESH_INTERVAL = 60*1000;
+var lastRefreshTime = 0;
+var REFRESH_WEATHER_INTERVAL = 30*60*1000;
+var REFRESH_PRECIP_WET_INTERVAL = 5*60*1000;  // While the last minutely feed had rain.
+var REFRESH_PRECIP_DRY_INTERVAL = 60*60*1000;
+var REFRESH_CALENDAR_MIN_INTERVAL = 5*60*1000;
+var REFRESH_CALENDAR_MAX_INTERVAL = 60*60*1000;
+var REFRESH_REPORT_DEFAULT_MINUTES = 30;
+var REFRESH_DISCONNECTED_FACTOR = 4;          // Applied while the watch is not answering.
+var REFRESH_MAX_INTERVAL = 4*60*60*1000;
+var WEATHER_DAY_GRAPH_SAMPLES = 48;
+var REPORT_TEXT_MAX_LENGTH = 1023;  // UTF-8 bytes, as are the lengths below.
+var CALENDAR_TEXT_MAX_LENGTH = 511;
 var CALENDAR_MAX_EVENTS = 8;
-var CALENDAR_ROW_MAX_LENGTH = 28;
+var CALENDAR_ROW_MAX_LENGTH = 60; // The watch ellipsizes rows to its width.
 var CALENDAR_LOOKAHEAD_DAYS = 90;
 var CALENDAR_RECURRENCE_SCAN_LIMIT = 5000;
+var CALENDAR_CACHE_STORAGE_KEY = "CalendarCache";
+var CALENDAR_CACHE_MAX_OCCURRENCES = 48;
+var CALENDAR_CACHE_MAX_AGE = 24*60*60; // Seconds; also re-anchors the lookahead window.
 
 Pebble.addEventListener('showConfiguration', function(e) {
   Pebble.openURL(clay.generateUrl());
@@ -33,7 +72,10 @@ Pebble.addEventListener('webviewclosed', function(e) {
   localStorage.setItem("CalendarUrls", CalendarUrls);
   CalendarColors = json_resp.CalendarColors.value;
   localStorage.setItem("CalendarColors", CalendarColors);
-  sendCalendar();
+  ReportInterval = json_resp.ReportInterval ? json_resp.ReportInterval.value : ReportInterval;
+  localStorage.setItem("ReportInterval", ReportInterval);
+  refreshSource("calendar");
+  scheduleRefresh("report");
 });
 
 var iconNameToId = {
@@ -195,10 +237,420 @@ function buildDayGraphData(hourlyData) {
   return {temps: temps, precip: precip};
 }
 
-function truncateText(value, maxLength) {
+function clampByte(value, fallback) {
+  if (!isFiniteNumber(value)) {return fallback;}
+  return Math.max(0, Math.min(255, Math.round(value)));
+}
+
+function int8Byte(value) {
+  return Math.max(-128, Math.min(127, value)) & 0xFF;
+}
+
+function pushBytes(bytes, values, length, fallback) {
+  values = values || [];
+  for (var i=0; i<length; i++) {
+    bytes.push(i < values.length ? clampByte(values[i], fallback) : fallback);
+  }
+}
+
+// Layout must match the WeatherRecord* groups in watchface.c: only the
+// groups whose flag is set are packed, in flag order.
+function packWeatherRecord(record) {
+  var bytes = [WEATHER_RECORD_VERSION, record.flags];
+  if (record.flags & WEATHER_RECORD_HAS_CURRENT) {
+    var current = record.current || {};
+    bytes.push(clampByte(current.icon, 0));
+    bytes.push(int8Byte(current.atemp === undefined ? WEATHER_TEMP_UNKNOWN : current.atemp));
+    bytes.push(int8Byte(current.temp === undefined ? WEATHER_TEMP_UNKNOWN : current.temp));
+    bytes.push(clampByte(current.humidity, 101));
+    var windSpeed = isFiniteNumber(current.windSpeed) ? Math.max(0, Math.min(65535, current.windSpeed)) : 1001;
+    bytes.push(windSpeed & 0xFF, (windSpeed >> 8) & 0xFF);
+    bytes.push(clampByte(current.uvIndex, 255));
+    bytes.push(clampByte(current.cloudCover, 101));
+    bytes.push(clampByte(current.visibility, 255));
+  }
+  if (record.flags & WEATHER_RECORD_HAS_BOUNDS) {
+    var bounds = record.bounds || {};
+    bytes.push(int8Byte(bounds.atempMax === undefined ? WEATHER_TEMP_UNKNOWN : bounds.atempMax));
+    bytes.push(int8Byte(bounds.atempMin === undefined ? WEATHER_TEMP_UNKNOWN : bounds.atempMin));
+    bytes.push(int8Byte(bounds.tempMax === undefined ? WEATHER_TEMP_UNKNOWN : bounds.tempMax));
+    bytes.push(int8Byte(bounds.tempMin === undefined ? WEATHER_TEMP_UNKNOWN : bounds.tempMin));
+  }
+  if (record.flags & WEATHER_RECORD_HAS_PRECIP_PROB) {
+    bytes.push(clampByte(record.precipProb, 0));
+  }
+  if (record.flags & WEATHER_RECORD_HAS_PRECIP_ARRAY) {
+    pushBytes(bytes, record.precipArray, WEATHER_PRECIP_SAMPLES, 0);
+  }
+  if (record.flags & WEATHER_RECORD_HAS_DAY_GRAPH) {
+    pushBytes(bytes, record.dayTemps, WEATHER_DAY_GRAPH_SAMPLES, 255);
+    pushBytes(bytes, record.dayPrecip, WEATHER_DAY_GRAPH_SAMPLES, 255);
+  }
+  return bytes;
+}
+
+// FNV-1a over the JSON form of a value; only used to detect changes.
+function hashValue(value) {
+  var text = JSON.stringify(value === undefined ? null : value);
+  var hash = 0x811c9dc5;
+  for (var i=0; i<text.length; i++) {
+    hash ^= text.charCodeAt(i);
+    hash += (hash << 1) + (hash << 4) + (hash << 7) + (hash << 8) + (hash << 24);
+    hash >>>= 0;
+  }
+  return hash;
+}
+
+// Hashes of the values the watch has acknowledged, by message key (or by
+// "key.group" for parts of the weather record).
+function loadSyncSnapshot() {
+  try {
+    return JSON.parse(localStorage.getItem(SYNC_SNAPSHOT_STORAGE_KEY)) || {};
+  } catch (e) {
+    return {};
+  }
+}
+
+function acknowledgeSyncHashes(hashes) {
+  var snapshot = loadSyncSnapshot();
+  for (var name in hashes) {
+    snapshot[name] = hashes[name];
+  }
+  localStorage.setItem(SYNC_SNAPSHOT_STORAGE_KEY, JSON.stringify(snapshot));
+}
+
+function resetSyncSnapshot() {
+  localStorage.removeItem(SYNC_SNAPSHOT_STORAGE_KEY);
+}
+
+// Every outbound AppMessage goes through one queue, so at most one message
+// is in flight. A failed send is retried ahead of the rest after an
+// exponential backoff, up to APP_MESSAGE_MAX_ATTEMPTS. Queueing a key that
+// is still waiting drops the older value; entry.onDrop(key) is told so it
+// can forget whatever it tracked for that value.
+var messageQueue = [];
+var messageInFlight = null;
+var messageRetryTimer = null;
+
+// Removes keys from a waiting entry; false once it has nothing left to send.
+function dropQueuedKeys(entry, keys) {
+  for (var i=0; i<keys.length; i++) {
+    if (!(keys[i] in entry.json)) {continue;}
+    delete entry.json[keys[i]];
+    if (entry.onDrop) {entry.onDrop(keys[i]);}
+  }
+  return Object.keys(entry.json).length > 0;
+}
+
+function queueAppMessage(json, callbacks) {
+  var keys = Object.keys(json);
+  messageQueue = messageQueue.filter(function (entry) {
+    return dropQueuedKeys(entry, keys);
+  });
+  callbacks = callbacks || {};
+  messageQueue.push({
+    json: json,
+    attempts: 0,
+    onSuccess: callbacks.onSuccess,
+    onFailure: callbacks.onFailure,
+    onDrop: callbacks.onDrop
+  });
+  sendNextAppMessage();
+}
+
+function retryAppMessage(entry) {
+  // Values queued since the failed send are newer; keep those.
+  var queuedKeys = [];
+  messageQueue.forEach(function (queued) {
+    queuedKeys = queuedKeys.concat(Object.keys(queued.json));
+  });
+  if (dropQueuedKeys(entry, queuedKeys)) {messageQueue.unshift(entry);}
+  messageRetryTimer = setTimeout(function () {
+    messageRetryTimer = null;
+    sendNextAppMessage();
+  }, APP_MESSAGE_RETRY_DELAY*Math.pow(2, entry.attempts - 1));
+}
+
+function sendNextAppMessage() {
+  if (messageInFlight || messageRetryTimer || !messageQueue.length) {return;}
+  var entry = messageQueue.shift();
+  messageInFlight = entry;
+  entry.attempts += 1;
+  Pebble.sendAppMessage(entry.json, function () {
+    messageInFlight = null;
+    setWatchReachable(true);
+    if (entry.onSuccess) {entry.onSuccess();}
+    sendNextAppMessage();
+  }, function () {
+    messageInFlight = null;
+    if (entry.attempts < APP_MESSAGE_MAX_ATTEMPTS) {
+      retryAppMessage(entry);
+      return;
+    }
+    console.log("AppMessage was not acknowledged: " + Object.keys(entry.json).join(","));
+    setWatchReachable(false);
+    if (entry.onFailure) {entry.onFailure();}
+    sendNextAppMessage();
+  });
+}
+
+// Chunked transfers (see src/c/transfer.h) for values that do not fit in
+// one AppMessage. One transfer is in flight at a time; the watch answers
+// every chunk with the index it wants next.
+var transferQueue = [];
+var activeTransfer = null;
+var nextTransferId = Date.now() & 0xFF;
+
+function utf8Bytes(text) {
+  var encoded = unescape(encodeURIComponent(text));
+  var bytes = [];
+  for (var i=0; i<encoded.length; i++) {
+    bytes.push(encoded.charCodeAt(i));
+  }
+  return bytes;
+}
+
+// Byte form of a message value when it is too large to send inline.
+function transferPayloadBytes(value) {
+  var bytes = typeof value === "string" ? utf8Bytes(value) : value;
+  if (!bytes || bytes.length <= TRANSFER_INLINE_MAX_LENGTH) {return null;}
+  return bytes;
+}
+
+function transferChunkCount(transfer) {
+  return Math.max(1, Math.ceil(transfer.bytes.length/TRANSFER_CHUNK_SIZE));
+}
+
+// A waiting transfer of the same key is replaced, like queued messages.
+function sendTransfer(key, bytes, done) {
+  transferQueue = transferQueue.filter(function (transfer) {
+    return transfer.key !== key;
+  });
+  transferQueue.push({key: key, bytes: bytes, done: done});
+  if (!activeTransfer) {startNextTransfer();}
+}
+
+function startNextTransfer() {
+  activeTransfer = transferQueue.shift() || null;
+  if (!activeTransfer) {return;}
+  activeTransfer.id = nextTransferId;
+  nextTransferId = (nextTransferId + 1) & 0xFF;
+  activeTransfer.retries = 0;
+  sendTransferChunk(activeTransfer, 0);
+}
+
+function finishTransfer(transfer, ok) {
+  clearTimeout(transfer.timer);
+  activeTransfer = null;
+  if (!ok) {console.log("Transfer of key " + transfer.key + " failed.");}
+  transfer.done(ok);
+  startNextTransfer();
+}
+
+// Called when the watch's reply to a delivered chunk does not come.
+function retryTransferChunk(transfer, index) {
+  if (transfer !== activeTransfer || transfer.index !== index) {return;}
+  transfer.retries += 1;
+  if (transfer.retries > TRANSFER_MAX_RETRIES) {
+    finishTransfer(transfer, false);
+    return;
+  }
+  sendTransferChunk(transfer, index);
+}
+
+function sendTransferChunk(transfer, index) {
+  var total = transfer.bytes.length;
+  var start = index*TRANSFER_CHUNK_SIZE;
+  var json = {};
+  json[TRANSFER_CHUNK_KEY] = [transfer.id, transfer.key,
+                              index & 0xFF, index >> 8,
+                              total & 0xFF, total >> 8]
+    .concat(transfer.bytes.slice(start, start + TRANSFER_CHUNK_SIZE));
+  transfer.index = index;
+  clearTimeout(transfer.timer);
+  queueAppMessage(json, {
+    onSuccess: function () {
+      if (transfer !== activeTransfer || transfer.index !== index) {return;}
+      transfer.timer = setTimeout(function() {
+        retryTransferChunk(transfer, index);
+      }, TRANSFER_REPLY_TIMEOUT);
+    },
+    onFailure: function () {
+      if (transfer === activeTransfer) {finishTransfer(transfer, false);}
+    }
+  });
+}
+
+function handleTransferReply(reply) {
+  var transfer = activeTransfer;
+  if (!transfer || !reply || reply[0] !== transfer.id) {return;}
+  var status = reply[1];
+  var nextIndex = reply[2] | (reply[3] << 8);
+  if (status === TRANSFER_REJECT) {
+    finishTransfer(transfer, false);
+    return;
+  }
+  if (status === TRANSFER_ACK) {
+    transfer.retries = 0;
+    if (nextIndex >= transferChunkCount(transfer)) {
+      finishTransfer(transfer, true);
+      return;
+    }
+  } else if (status === TRANSFER_NACK) {
+    transfer.retries += 1;
+    if (transfer.retries > TRANSFER_MAX_RETRIES) {
+      finishTransfer(transfer, false);
+      return;
+    }
+  }
+  sendTransferChunk(transfer, nextIndex);
+}
+
+function acknowledgeTransfer(hashes) {
+  return function(ok) {
+    if (ok) {acknowledgeSyncHashes(hashes);}
+  };
+}
+
+// Values too large for one AppMessage go through a transfer each and are
+// acknowledged on their own; the rest share one message.
+function sendSyncMessage(json, hashes) {
+  var inlineJson = {};
+  var inlineHashes = {};
+  var hasInline = false;
+  for (var name in hashes) {
+    inlineHashes[name] = hashes[name];
+  }
+  for (var key in json) {
+    var bytes = transferPayloadBytes(json[key]);
+    if (bytes) {
+      var transferHashes = {};
+      transferHashes[key] = hashes[key];
+      delete inlineHashes[key];
+      sendTransfer(Number(key), bytes, acknowledgeTransfer(transferHashes));
+      continue;
+    }
+    inlineJson[key] = json[key];
+    hasInline = true;
+  }
+  if (!hasInline) {return;}
+
+  queueAppMessage(inlineJson, {
+    onSuccess: function () {
+      acknowledgeSyncHashes(inlineHashes);
+    },
+    // Weather record groups are hashed as "key.group".
+    onDrop: function (key) {
+      for (var name in inlineHashes) {
+        if (name === key || name.indexOf(key + ".") === 0) {delete inlineHashes[name];}
+      }
+    }
+  });
+}
+
+// Send only the keys whose value differs from what the watch last
+// acknowledged; skip the message entirely when nothing changed.
+function sendChangedAppMessage(json) {
+  var snapshot = loadSyncSnapshot();
+  var changed = {};
+  var hashes = {};
+  var hasChanges = false;
+  for (var key in json) {
+    var hash = hashValue(json[key]);
+    if (snapshot[key] === hash) {continue;}
+    changed[key] = json[key];
+    hashes[key] = hash;
+    hasChanges = true;
+  }
+  if (!hasChanges) {
+    console.log("Skipping unchanged message: " + Object.keys(json).join(","));
+    return;
+  }
+  sendSyncMessage(changed, hashes);
+}
+
+function isAllZero(values) {
+  for (var i=0; i<(values || []).length; i++) {
+    if (values[i]) {return false;}
+  }
+  return true;
+}
+
+// The weather record is delta-synced per field group by clearing the flags
+// of unchanged groups. The minute precip array and the day graph are indexed
+// from the time of the fetch, so they are always resent unless the precip
+// array is all zeros, which renders the same at any offset.
+//
+// Weather and minutely precipitation are fetched separately but share the
+// key, and queueing the key drops a record still waiting. So a new record
+// takes over the groups of one that has not been delivered yet.
+var queuedWeatherRecord = null;
+
+function mergeQueuedWeatherRecord(record) {
+  var queued = queuedWeatherRecord;
+  if (!queued) {return;}
+  var pending = [messageInFlight].concat(messageQueue).some(function (entry) {
+    return entry && entry.json[WEATHER_RECORD_KEY] === queued.bytes;
+  });
+  if (!pending) {return;}
+  for (var name in queued.record) {
+    if (record[name] === undefined) {record[name] = queued.record[name];}
+  }
+  record.flags |= queued.record.flags;
+}
+
+function sendWeatherRecord(record) {
+  mergeQueuedWeatherRecord(record);
+  var snapshot = loadSyncSnapshot();
+  var groups = [
+    {flag: WEATHER_RECORD_HAS_CURRENT, name: "current", value: record.current},
+    {flag: WEATHER_RECORD_HAS_BOUNDS, name: "bounds", value: record.bounds},
+    {flag: WEATHER_RECORD_HAS_PRECIP_PROB, name: "precipProb", value: record.precipProb},
+    {flag: WEATHER_RECORD_HAS_PRECIP_ARRAY, name: "precipArray", value: record.precipArray,
+     timeRelative: !isAllZero(record.precipArray)},
+    {flag: WEATHER_RECORD_HAS_DAY_GRAPH, name: "dayGraph", value: null, timeRelative: true}
+  ];
+  var hashes = {};
+  for (var i=0; i<groups.length; i++) {
+    var group = groups[i];
+    if (!(record.flags & group.flag)) {continue;}
+    var name = WEATHER_RECORD_KEY + "." + group.name;
+    if (group.timeRelative) {
+      hashes[name] = null;
+      continue;
+    }
+    var hash = hashValue(group.value);
+    if (snapshot[name] === hash) {
+      record.flags &= ~group.flag;
+    } else {
+      hashes[name] = hash;
+    }
+  }
+  if (!record.flags) {
+    console.log("Skipping unchanged weather record.");
+    return;
+  }
+  var json = {};
+  json[WEATHER_RECORD_KEY] = packWeatherRecord(record);
+  queuedWeatherRecord = {record: record, bytes: json[WEATHER_RECORD_KEY]};
+  sendSyncMessage(json, hashes);
+}
+
+// Cuts value to at most maxBytes once UTF-8 encoded, the unit of the
+// watch's text buffers, without splitting a character.
+function truncateText(value, maxBytes) {
   value = value || "";
-  if (value.length <= maxLength) {return value;}
-  return value.substring(0, maxLength);
+  var bytes = 0;
+  for (var i=0; i<value.length; i++) {
+    var code = value.charCodeAt(i);
+    var next = value.charCodeAt(i+1);
+    var pair = code >= 0xD800 && code <= 0xDBFF && next >= 0xDC00 && next <= 0xDFFF;
+    var size = pair ? 4 : code < 0x80 ? 1 : code < 0x800 ? 2 : 3;
+    if (bytes + size > maxBytes) {return value.substring(0, i);}
+    bytes += size;
+    if (pair) {i += 1;}
+  }
+  return value;
 }
 
 function trimText(value) {
@@ -250,11 +702,11 @@ function padTwo(value) {
   return value < 10 ? "0" + value : "" + value;
 }
 
-function formatCalendarTime(time) {
-  if (!time) {return "--:--";}
-  if (time.isDate) {return "All day";}
+function formatCalendarTime(event) {
+  if (!event || !isFiniteNumber(event.startUnix)) {return "--:--";}
+  if (event.allDay) {return "All day";}
 
-  var date = time.toJSDate();
+  var date = new Date(event.startUnix*1000);
   return padTwo(date.getHours()) + ":" + padTwo(date.getMinutes());
 }
 
@@ -270,7 +722,8 @@ function buildCalendarWindow(now) {
   };
 }
 
-function buildCalendarOccurrence(item, startDate, endDate, timeWindow, colorId) {
+// Occurrences are plain objects so they can be cached in localStorage.
+function buildCalendarOccurrence(item, startDate, endDate, timeWindow) {
   if (!startDate) {return null;}
 
   var startUnix = calendarTimeToUnix(startDate);
@@ -278,10 +731,10 @@ function buildCalendarOccurrence(item, startDate, endDate, timeWindow, colorId)
   if (endUnix < timeWindow.startUnix || startUnix > timeWindow.endUnix) {return null;}
 
   return {
-    startDate: startDate,
     startUnix: startUnix,
-    summary: cleanSingleLineText(item && item.summary) || "(untitled)",
-    colorId: colorId || 0
+    endUnix: endUnix,
+    allDay: !!startDate.isDate,
+    summary: cleanSingleLineText(item && item.summary) || "(untitled)"
   };
 }
 
@@ -289,38 +742,55 @@ function calendarStartsAfterWindow(startDate, timeWindow) {
   return startDate && calendarTimeToUnix(startDate) > timeWindow.endUnix;
 }
 
-function collectRecurringCalendarEvents(event, timeWindow, colorId) {
+// Expands at most CALENDAR_MAX_EVENTS occurrences. When the expansion stops
+// early, timeWindow.coverageEnd is lowered to the last start it reached:
+// later occurrences of this event may exist but were not collected.
+function collectRecurringCalendarEvents(event, timeWindow) {
   var events = [];
   var iterator = event.iterator();
   var occurrence = null;
   var scanCount = 0;
-
-  while ((occurrence = iterator.next()) && scanCount < CALENDAR_RECURRENCE_SCAN_LIMIT) {
+  var lastStartUnix = timeWindow.startUnix;
+  var complete = false;
+
+  while (scanCount < CALENDAR_RECURRENCE_SCAN_LIMIT) {
+    occurrence = iterator.next();
+    if (!occurrence) {
+      complete = true;
+      break;
+    }
     scanCount += 1;
 
     var details = event.getOccurrenceDetails(occurrence);
     if (!details || !details.startDate) {continue;}
-    if (calendarStartsAfterWindow(details.startDate, timeWindow)) {break;}
+    if (calendarStartsAfterWindow(details.startDate, timeWindow)) {
+      complete = true;
+      break;
+    }
+    lastStartUnix = calendarTimeToUnix(details.startDate);
 
     var calendarEvent = buildCalendarOccurrence(details.item || event,
                                                 details.startDate,
                                                 details.endDate,
-                                                timeWindow, colorId);
+                                                timeWindow);
     if (calendarEvent) {events.push(calendarEvent);}
     if (events.length >= CALENDAR_MAX_EVENTS) {break;}
   }
 
+  if (!complete) {
+    timeWindow.coverageEnd = Math.min(timeWindow.coverageEnd, lastStartUnix);
+  }
   return events;
 }
 
-function collectCalendarEventOccurrences(event, timeWindow, colorId) {
+function collectCalendarEventOccurrences(event, timeWindow) {
   if (event.isRecurrenceException() || !event.startDate) {return [];}
   if (event.isRecurring()) {
-    return collectRecurringCalendarEvents(event, timeWindow, colorId);
+    return collectRecurringCalendarEvents(event, timeWindow);
   }
 
   var calendarEvent = buildCalendarOccurrence(event, event.startDate, event.endDate,
-                                              timeWindow, colorId);
+                                              timeWindow);
   return calendarEvent ? [calendarEvent] : [];
 }
 
@@ -333,17 +803,21 @@ function limitCalendarEvents(events) {
   return events.slice(0, CALENDAR_MAX_EVENTS);
 }
 
-function buildUpcomingCalendarEvents(icsText, now, colorId) {
+// Parses an ICS feed into a cacheable entry: the earliest occurrences in
+// the lookahead window, complete up to coverageEnd (null when complete for
+// the whole window).
+function buildUpcomingCalendarEvents(icsText, now) {
   var calendar = new ICAL.Component(ICAL.parse(icsText));
   registerCalendarTimezones(calendar);
   var components = calendar.getAllSubcomponents("vevent");
   var timeWindow = buildCalendarWindow(now);
+  timeWindow.coverageEnd = Infinity;
   var events = [];
 
   for (var i=0; i<components.length; i++) {
     try {
       var event = new ICAL.Event(components[i]);
-      var occurrences = collectCalendarEventOccurrences(event, timeWindow, colorId);
+      var occurrences = collectCalendarEventOccurrences(event, timeWindow);
       for (var j=0; j<occurrences.length; j++) {
         events.push(occurrences[j]);
       }
@@ -352,13 +826,77 @@ function buildUpcomingCalendarEvents(icsText, now, colorId) {
     }
   }
 
-  return limitCalendarEvents(events);
+  events.sort(compareCalendarEvents);
+  if (events.length > CALENDAR_CACHE_MAX_OCCURRENCES) {
+    events = events.slice(0, CALENDAR_CACHE_MAX_OCCURRENCES);
+    timeWindow.coverageEnd = Math.min(timeWindow.coverageEnd,
+                                      events[events.length-1].startUnix);
+  }
+  var coverageEnd = isFinite(timeWindow.coverageEnd) ? timeWindow.coverageEnd : null;
+  return {
+    parsedUnix: timeWindow.startUnix,
+    coverageEnd: coverageEnd,
+    occurrences: events.filter(function (event) {
+      return coverageEnd === null || event.startUnix <= coverageEnd;
+    })
+  };
+}
+
+// Re-filters cached occurrences against the current time. Returns null when
+// the cache cannot answer for sure and the feed has to be parsed again.
+function filterCalendarOccurrences(entry, now, colorId) {
+  if (!entry || !entry.occurrences) {return null;}
+  var timeWindow = buildCalendarWindow(now);
+  if (timeWindow.startUnix - entry.parsedUnix > CALENDAR_CACHE_MAX_AGE) {return null;}
+
+  var events = [];
+  for (var i=0; i<entry.occurrences.length; i++) {
+    var occurrence = entry.occurrences[i];
+    if (occurrence.endUnix < timeWindow.startUnix ||
+        occurrence.startUnix > timeWindow.endUnix) {continue;}
+    events.push({
+      startUnix: occurrence.startUnix,
+      endUnix: occurrence.endUnix,
+      allDay: occurrence.allDay,
+      summary: occurrence.summary,
+      colorId: colorId || 0
+    });
+  }
+  events = limitCalendarEvents(events);
+  if (entry.coverageEnd !== null && events.length < CALENDAR_MAX_EVENTS) {return null;}
+  return events;
+}
+
+function loadCalendarCache() {
+  try {
+    return JSON.parse(localStorage.getItem(CALENDAR_CACHE_STORAGE_KEY)) || {};
+  } catch (e) {
+    return {};
+  }
+}
+
+function saveCalendarCache(cache) {
+  try {
+    localStorage.setItem(CALENDAR_CACHE_STORAGE_KEY, JSON.stringify(cache));
+  } catch (e) {
+    console.log("Calendar cache not saved: " + e.message);
+  }
+}
+
+// Drop entries for URLs that are no longer configured.
+function pruneCalendarCache(urls) {
+  var cache = loadCalendarCache();
+  var pruned = {};
+  for (var i=0; i<urls.length; i++) {
+    if (cache[urls[i]]) {pruned[urls[i]] = cache[urls[i]];}
+  }
+  saveCalendarCache(pruned);
 }
 
 function buildCalendarMessage(events) {
   var rows = [];
   for (var i=0; i<events.length; i++) {
-    rows.push(truncateText(formatCalendarTime(events[i].startDate) + " " +
+    rows.push(truncateText(formatCalendarTime(events[i]) + " " +
                            events[i].summary, CALENDAR_ROW_MAX_LENGTH));
   }
   return truncateText(rows.join("\n"), CALENDAR_TEXT_MAX_LENGTH);
@@ -372,17 +910,39 @@ function buildCalendarColorData(events) {
   return colors;
 }
 
+// When the listed events next change: the earliest start or end still
+// ahead of now, in Unix seconds, or null.
+function nextCalendarChange(events, nowUnix) {
+  var next = null;
+  for (var i=0; i<events.length; i++) {
+    var times = [events[i].startUnix, events[i].endUnix];
+    for (var j=0; j<times.length; j++) {
+      if (times[j] > nowUnix && (next === null || times[j] < next)) {next = times[j];}
+    }
+  }
+  return next;
+}
+
 function sendCalendarEvents(events) {
   var visibleEvents = limitCalendarEvents(events);
+  nextCalendarChangeUnix = nextCalendarChange(visibleEvents, Math.floor(Date.now()/1000));
   var json = {};
   json[CALENDAR_KEY] = buildCalendarMessage(visibleEvents);
   json[CALENDAR_COLORS_KEY] = buildCalendarColorData(visibleEvents);
-  Pebble.sendAppMessage(json);
+  sendChangedAppMessage(json);
 }
 
+// Fetches one ICS feed, revalidating with the cached ETag/Last-Modified.
+// On 304 the cached occurrences are re-filtered and the parse is skipped.
 function requestCalendarEvents(url, colorId, now, done) {
+    var entry = loadCalendarCache()[url];
+    var cachedEvents = filterCalendarOccurrences(entry, now, colorId);
     var req = new XMLHttpRequest();
     req.addEventListener("load", function (){
+        if (req.status === 304 && cachedEvents) {
+            done(cachedEvents);
+            return;
+        }
         if (req.status && (req.status < 200 || req.status >= 300)) {
             console.log("Calendar request failed: " + req.status + " " + url);
             done(null);
@@ -390,8 +950,18 @@ function requestCalendarEvents(url, colorId, now, done) {
         }
 
         try {
-            done(buildUpcomingCalendarEvents(req.responseText || req.response || "",
-                                             now, colorId));
+            var parsed = buildUpcomingCalendarEvents(req.responseText || req.response || "",
+                                                     now);
+            parsed.etag = req.getResponseHeader("ETag");
+            parsed.lastModified = req.getResponseHeader("Last-Modified");
+            var cache = loadCalendarCache();
+            cache[url] = parsed;
+            saveCalendarCache(cache);
+            done(filterCalendarOccurrences(parsed, now, colorId) ||
+                 limitCalendarEvents(parsed.occurrences.map(function (event) {
+                   event.colorId = colorId || 0;
+                   return event;
+                 })));
         } catch (e) {
             console.log("Calendar parse failed: " + e.message + " " + url);
             done(null);
@@ -402,6 +972,10 @@ function requestCalendarEvents(url, colorId, now, done) {
         done(null);
     });
     req.open("GET", url);
+    if (cachedEvents) {
+        if (entry.etag) {req.setRequestHeader("If-None-Match", entry.etag);}
+        if (entry.lastModified) {req.setRequestHeader("If-Modified-Since", entry.lastModified);}
+    }
     req.send();
 }
 
@@ -432,35 +1006,54 @@ function requestJson(url, done) {
   req.send();
 }
 
-function sendWeather() {
+// Calls done(baseUrl, query) for the OpenWeather endpoints at the
+// current position.
+function withWeatherQuery(done) {
     if (OpenWeatherKey) {
         console.log("Setting up getCurrentPosition.");
         navigator.geolocation.getCurrentPosition(
         function (pos){
             console.log("Got position, setting up OpenWeather requests.");
-            var pending = 4;
-            var hasWeatherData = false;
-            var json = {};
-            var dailyTemperatureBounds = null;
-            var hourlyTemperatureBounds = null;
             var query = "?lat="+pos.coords.latitude+"&lon="+pos.coords.longitude+"&units=metric&appid="+encodeURIComponent(OpenWeatherKey);
-            var baseUrl = "https://api.openweathermap.org/data/4.0/onecall/";
+            done("https://api.openweathermap.org/data/4.0/onecall/", query);
+        },
+        function (err) {
+            console.log("Error with getCurrentPosition.");
+            if(err.code == err.PERMISSION_DENIED) console.log('Location access was denied by the user.');  
+            else console.log('location error (' + err.code + '): ' + err.message);
+        },
+        {
+            enableHighAccuracy: false,
+            maximumAge: 1000*60*10,
+            timeout: 10000
+        }
+        );
+        console.log("getCurrentPosition setup complete.");
+    }
+}
 
-            function put(key, value) {
-              json[key] = value;
-              hasWeatherData = true;
-            }
+// Current conditions, bounds and the day graph; the minutely precipitation
+// is fetched on its own cadence by sendPrecipitation.
+function sendWeather() {
+    withWeatherQuery(function (baseUrl, query){
+            var pending = 3;
+            var record = {flags: 0};
+            var dailyTemperatureBounds = null;
+            var hourlyTemperatureBounds = null;
 
             function finishRequest() {
               pending -= 1;
-              if (pending === 0 && hasWeatherData) {
+              if (pending === 0 && (record.flags || dailyTemperatureBounds)) {
                 dailyTemperatureBounds = dailyTemperatureBounds || {};
                 hourlyTemperatureBounds = hourlyTemperatureBounds || {};
-                put(2, temperatureOrFallback(dailyTemperatureBounds.atempMax, hourlyTemperatureBounds.atempMax)); // Celsius
-                put(3, temperatureOrFallback(dailyTemperatureBounds.atempMin, hourlyTemperatureBounds.atempMin)); // Celsius
-                put(5, temperatureOrFallback(dailyTemperatureBounds.tempMax, hourlyTemperatureBounds.tempMax));   // Celsius
-                put(6, temperatureOrFallback(dailyTemperatureBounds.tempMin, hourlyTemperatureBounds.tempMin));   // Celsius
-                Pebble.sendAppMessage(json);
+                record.bounds = {
+                  atempMax: temperatureOrFallback(dailyTemperatureBounds.atempMax, hourlyTemperatureBounds.atempMax), // Celsius
+                  atempMin: temperatureOrFallback(dailyTemperatureBounds.atempMin, hourlyTemperatureBounds.atempMin), // Celsius
+                  tempMax: temperatureOrFallback(dailyTemperatureBounds.tempMax, hourlyTemperatureBounds.tempMax),    // Celsius
+                  tempMin: temperatureOrFallback(dailyTemperatureBounds.tempMin, hourlyTemperatureBounds.tempMin)     // Celsius
+                };
+                record.flags |= WEATHER_RECORD_HAS_BOUNDS;
+                sendWeatherRecord(record);
               }
             }
 
@@ -468,14 +1061,17 @@ function sendWeather() {
               var current = firstData(response);
               var weather = current && current.weather && current.weather.length ? current.weather[0] : null;
               if (current) {
-                put(0, openWeatherIconToId(weather));                 // id - check the c source
-                put(1, roundTemperature(current.feels_like));          // Celsius
-                put(4, roundTemperature(current.temp));                // Celsius
-                put(9, roundValue(current.humidity, 101));            // Percents
-                put(10, roundValue(current.wind_speed*10, 1001));     // dm/s
-                put(14, roundBoundedValue(current.uvi, 255, 0, 254)); // UV index
-                put(15, roundBoundedValue(current.clouds, 101, 0, 100)); // Percents
-                put(16, roundBoundedValue(current.visibility/1000, 255, 0, 254)); // Kilometers
+                record.current = {
+                  icon: openWeatherIconToId(weather),                              // id - check the c source
+                  atemp: roundTemperature(current.feels_like),                     // Celsius
+                  temp: roundTemperature(current.temp),                            // Celsius
+                  humidity: roundValue(current.humidity, 101),                     // Percents
+                  windSpeed: roundValue(current.wind_speed*10, 1001),              // dm/s
+                  uvIndex: roundBoundedValue(current.uvi, 255, 0, 254),            // UV index
+                  cloudCover: roundBoundedValue(current.clouds, 101, 0, 100),      // Percents
+                  visibility: roundBoundedValue(current.visibility/1000, 255, 0, 254) // Kilometers
+                };
+                record.flags |= WEATHER_RECORD_HAS_CURRENT;
               }
               finishRequest();
             });
@@ -484,7 +1080,6 @@ function sendWeather() {
               var day = firstData(response);
               if (day) {
                 dailyTemperatureBounds = buildDailyTemperatureBounds(day);
-                hasWeatherData = true;
               }
               finishRequest();
             });
@@ -498,10 +1093,12 @@ function sendWeather() {
                   var graphData = buildDayGraphData(data);
                   hourlyTemperatureBounds = buildHourlyTemperatureBounds(data.slice(0, 25));
                   if (precipProb !== null) {
-                    put(7, precipProb);                                                              // Percents
+                    record.precipProb = precipProb;                                                  // Percents
+                    record.flags |= WEATHER_RECORD_HAS_PRECIP_PROB;
                   }
-                  put(12, graphData.temps);                                                          // Apparent temp, Celsius + 100
-                  put(13, graphData.precip);                                                         // Precipitation probability
+                  record.dayTemps = graphData.temps;                                                 // Apparent temp, Celsius + 100
+                  record.dayPrecip = graphData.precip;                                               // Precipitation probability
+                  record.flags |= WEATHER_RECORD_HAS_DAY_GRAPH;
                 }
                 finishRequest();
               }
@@ -519,32 +1116,26 @@ function sendWeather() {
               }
             });
 
+    });
+}
+
+function sendPrecipitation() {
+    withWeatherQuery(function (baseUrl, query){
             requestJson(baseUrl+"timeline/1min"+query, function (response){
               if (response && response.data) {
                 var minuteData = [];
-                for (var i=0; i<60; i++) {
+                for (var i=0; i<WEATHER_PRECIP_SAMPLES; i++) {
                   var minute = response.data[i];
                   var precipitation = minute && isFiniteNumber(minute.precipitation) ? minute.precipitation : 0;
                   minuteData.push(Math.min(Math.round(precipitation/10*255), 255)); // mm/h scaled to a byte
                 }
-                put(8, minuteData);
+                precipitationExpected = !isAllZero(minuteData);
+                sendWeatherRecord({flags: WEATHER_RECORD_HAS_PRECIP_ARRAY,
+                                   precipArray: minuteData});
               }
-              finishRequest();
+              scheduleRefresh("precipitation");
             });
-        },
-        function (err) {
-            console.log("Error with getCurrentPosition.");
-            if(err.code == err.PERMISSION_DENIED) console.log('Location access was denied by the user.');  
-            else console.log('location error (' + err.code + '): ' + err.message);
-        },
-        {
-            enableHighAccuracy: false,
-            maximumAge: 1000*60*10,
-            timeout: 10000
-        }
-        );
-        console.log("getCurrentPosition setup complete.");
-    }
+    });
 }
 
 function sendReport() {
@@ -559,7 +1150,7 @@ function sendReport() {
             var json = {};
             json[REPORT_KEY] = truncateText(req.responseText || req.response || "",
                                             REPORT_TEXT_MAX_LENGTH);
-            Pebble.sendAppMessage(json);
+            sendChangedAppMessage(json);
         });
         req.addEventListener("error", function (){
             console.log("Report request failed.");
@@ -573,6 +1164,7 @@ function sendCalendar() {
     var urls = splitCommaList(CalendarUrls, false);
     if (!urls.length) {return;}
 
+    pruneCalendarCache(urls);
     var calendarColorIds = parseCalendarColors(CalendarColors);
     var pending = urls.length;
     var allEvents = [];
@@ -586,6 +1178,7 @@ function sendCalendar() {
         if (sawCalendarData) {
             sendCalendarEvents(allEvents);
         }
+        scheduleRefresh("calendar");
     }
 
     for (var i=0; i<urls.length; i++) {
@@ -601,6 +1194,112 @@ function sendCalendar() {
     }
 }
 
-Pebble.addEventListener("ready", function() {sendWeather(); sendReport(); sendCalendar();});
+// Each source refreshes on its own timer. The interval is taken when the
+// timer is set, and sources whose cadence depends on what they fetched set
+// it again once the fetch completes.
+var precipitationExpected = false;
+var nextCalendarChangeUnix = null;
+var watchReachable = true;
+var refreshTimers = {};
+var refreshTimes = {};
+var refreshSources = {
+  weather: {
+    requestFlag: 0x01, // REFRESH_WEATHER in watchface.c, and so on.
+    refresh: function () {sendWeather();},
+    interval: function () {return REFRESH_WEATHER_INTERVAL;}
+  },
+  precipitation: {
+    requestFlag: 0x02,
+    refresh: function () {sendPrecipitation();},
+    interval: function () {
+      return precipitationExpected ? REFRESH_PRECIP_WET_INTERVAL : REFRESH_PRECIP_DRY_INTERVAL;
+    }
+  },
+  report: {
+    requestFlag: 0x04,
+    refresh: function () {sendReport();},
+    interval: function () {
+      var minutes = parseInt(ReportInterval, 10);
+      return (minutes > 0 ? minutes : REFRESH_REPORT_DEFAULT_MINUTES)*60*1000;
+    }
+  },
+  calendar: {
+    requestFlag: 0x08,
+    refresh: function () {sendCalendar();},
+    interval: function () {
+      if (nextCalendarChangeUnix === null) {return REFRESH_CALENDAR_MAX_INTERVAL;}
+      // A minute late, so the event has started by the time we look.
+      var untilChange = nextCalendarChangeUnix*1000 - Date.now() + 60*1000;
+      return Math.max(REFRESH_CALENDAR_MIN_INTERVAL,
+                      Math.min(REFRESH_CALENDAR_MAX_INTERVAL, untilChange));
+    }
+  }
+};
+
+function scheduleRefresh(name) {
+  var interval = refreshSources[name].interval();
+  if (!watchReachable) {
+    interval = Math.min(interval*REFRESH_DISCONNECTED_FACTOR, REFRESH_MAX_INTERVAL);
+  }
+  clearTimeout(refreshTimers[name]);
+  refreshTimers[name] = setTimeout(function () {refreshSource(name);}, interval);
+}
+
+function refreshSource(name) {
+  refreshTimes[name] = Date.now();
+  refreshSources[name].refresh();
+  scheduleRefresh(name);
+}
+
+// PebbleKit JS has no connection event, so an AppMessage that exhausted its
+// retries stands in for a disconnect and any acknowledged message or
+// inbound message for a reconnect.
+function setWatchReachable(reachable) {
+  if (reachable === watchReachable) {return;}
+  watchReachable = reachable;
+  console.log(reachable ? "Watch answering again." : "Watch not answering; backing off refreshes.");
+  Object.keys(refreshTimers).forEach(scheduleRefresh);
+}
+
+// The watch asks for sources whose graphs are running out of samples, and
+// for everything after it reconnects.
+function handleRefreshRequest(flags) {
+  Object.keys(refreshSources).forEach(function (name) {
+    if (!(flags & refreshSources[name].requestFlag)) {return;}
+    if (Date.now() - (refreshTimes[name] || 0) < REFRESH_REQUEST_MIN_AGE) {return;}
+    refreshSource(name);
+  });
+}
+
+function refreshAll() {
+  lastRefreshTime = Date.now();
+  Object.keys(refreshSources).forEach(refreshSource);
+}
+
+// The watch starts with nothing of ours, so the first round is a full resend.
+Pebble.addEventListener("ready", function() {
+  resetSyncSnapshot();
+  refreshAll();
+});
+
+Pebble.addEventListener("appmessage", function(e) {
+  var payload = e && e.payload ? e.payload : {};
+  setWatchReachable(true);
+  var reply = payload[TRANSFER_REPLY_KEY];
+  if (reply === undefined) {reply = payload.TRANSFER_REPLY_KEY;}
+  if (reply !== undefined) {handleTransferReply(reply);}
+
+  var refreshRequest = payload[REFRESH_REQUEST_KEY];
+  if (refreshRequest === undefined) {refreshRequest = payload.REFRESH_REQUEST_KEY;}
+  if (refreshRequest !== undefined) {handleRefreshRequest(refreshRequest);}
+
+  var status = payload[WATCH_STATUS_KEY];
+  if (status === undefined) {status = payload.WATCH_STATUS_KEY;}
+  if (status === WATCH_STATUS_FRESH_START) {
+    resetSyncSnapshot();
+    if (Date.now() - lastRefreshTime > FRESH_START_REFRESH_INTERVAL) {
+      refreshAll();
+    }
+  }
+});
 
-setInterval(function(){sendWeather(); sendReport(); sendCalendar();}, 30*60*1000);
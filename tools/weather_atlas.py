@@ -0,0 +1,177 @@
+"""Pack the weather icons into one pre-tinted atlas image.
+
+The watch loads resources/images/weather_atlas_25.png once and cuts each
+icon out of it with gbitmap_create_as_sub_bitmap, so icon changes neither
+read a resource nor tint pixels.  Icon n (the WEATHER_ICON values sent by
+index.js, 1-based) sits at x = (n-1)*ICON_SIZE.  Each icon keeps its source
+alpha and takes its colour from ICONS below, which replaces the colour
+switch the watch used to tint with at runtime.
+
+The atlas is committed so the SDK can pack it like any other resource.
+wscript fails the build when it no longer matches the source icons; after
+changing an icon or ICONS, regenerate it and commit the result:
+
+    python tools/weather_atlas.py
+"""
+
+import os
+import struct
+import sys
+import zlib
+
+ICON_SIZE = 25
+
+YELLOW = (0xFF, 0xFF, 0x00)
+CYAN = (0x00, 0xFF, 0xFF)
+WHITE = (0xFF, 0xFF, 0xFF)
+
+# In WEATHER_ICON order; keep in step with weather_icon_atlas_rect in watchface.c.
+ICONS = [
+    ('Sun_25.png', YELLOW),                  # 1 clear day
+    ('Bright_Moon_25.png', WHITE),           # 2 clear night
+    ('Rain_25.png', CYAN),                   # 3 rain/thunderstorm
+    ('Snow_25.png', CYAN),                   # 4 snow
+    ('Sleet_25.png', CYAN),                  # 5 sleet
+    ('Air_Element_25.png', WHITE),           # 6 wind
+    ('Dust_25.png', WHITE),                  # 7 fog/haze/dust
+    ('Clouds_25.png', WHITE),                # 8 cloudy
+    ('Partly_Cloudy_Day_25.png', YELLOW),    # 9 partly cloudy day
+    ('Partly_Cloudy_Night_25.png', WHITE),   # 10 partly cloudy night
+]
+
+ATLAS_NAME = 'weather_atlas_25.png'
+
+_CHANNELS = {0: 1, 2: 3, 4: 2, 6: 4}  # PNG colour type -> samples per pixel
+
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def _read_png(path):
+    """Return (width, height, channels, unfiltered rows) of an 8-bit PNG."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('%s: not a PNG' % path)
+    pos = 8
+    idat = b''
+    width = height = color_type = None
+    while pos < len(data):
+        length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            width, height, depth, color_type, _, _, interlace = \
+                struct.unpack('>IIBBBBB', chunk)
+            if depth != 8 or interlace or color_type not in _CHANNELS:
+                raise ValueError('%s: unsupported PNG layout' % path)
+        elif kind == b'IDAT':
+            idat += chunk
+        elif kind == b'IEND':
+            break
+
+    channels = _CHANNELS[color_type]
+    stride = width * channels
+    raw = bytearray(zlib.decompress(idat))
+    rows = []
+    previous = bytearray(stride)
+    for y in range(height):
+        start = y * (stride + 1)
+        kind = raw[start]
+        row = raw[start + 1:start + 1 + stride]
+        for i in range(stride):
+            left = row[i - channels] if i >= channels else 0
+            up = previous[i]
+            up_left = previous[i - channels] if i >= channels else 0
+            if kind == 1:
+                row[i] = (row[i] + left) & 0xFF
+            elif kind == 2:
+                row[i] = (row[i] + up) & 0xFF
+            elif kind == 3:
+                row[i] = (row[i] + ((left + up) >> 1)) & 0xFF
+            elif kind == 4:
+                row[i] = (row[i] + _paeth(left, up, up_left)) & 0xFF
+        previous = row
+        rows.append(row)
+    return width, height, color_type, rows
+
+
+def read_png_alpha(path):
+    """Return (width, height, rows of alpha values) of an 8-bit PNG."""
+    width, height, color_type, rows = _read_png(path)
+    channels = _CHANNELS[color_type]
+    if color_type not in (4, 6):
+        return width, height, [[0xFF] * width for _ in rows]
+    return width, height, [[row[x * channels + channels - 1] for x in range(width)]
+                           for row in rows]
+
+
+def read_png_rgba(path):
+    """Return (width, height, pixels) of an 8-bit RGBA PNG, row-major."""
+    width, height, color_type, rows = _read_png(path)
+    if color_type != 6:
+        raise ValueError('%s: expected RGBA' % path)
+    pixels = []
+    for row in rows:
+        pixels.extend(tuple(row[x * 4:x * 4 + 4]) for x in range(width))
+    return width, height, pixels
+
+
+def _chunk(kind, body):
+    crc = zlib.crc32(kind + body) & 0xFFFFFFFF
+    return struct.pack('>I', len(body)) + kind + body + struct.pack('>I', crc)
+
+
+def write_png_rgba(path, width, height, pixels):
+    raw = bytearray()
+    for y in range(height):
+        raw.append(0)
+        for r, g, b, a in pixels[y * width:(y + 1) * width]:
+            raw.extend((r, g, b, a))
+    png = (b'\x89PNG\r\n\x1a\n' +
+           _chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 6, 0, 0, 0)) +
+           _chunk(b'IDAT', zlib.compress(bytes(raw), 9)) +
+           _chunk(b'IEND', b''))
+    with open(path, 'wb') as f:
+        f.write(png)
+
+
+def atlas_pixels(image_dir):
+    width = ICON_SIZE * len(ICONS)
+    pixels = [(0, 0, 0, 0)] * (width * ICON_SIZE)
+    for index, (name, color) in enumerate(ICONS):
+        w, h, alpha = read_png_alpha(os.path.join(image_dir, name))
+        if (w, h) != (ICON_SIZE, ICON_SIZE):
+            raise ValueError('%s: expected %dx%d' % (name, ICON_SIZE, ICON_SIZE))
+        for y in range(h):
+            for x in range(w):
+                if alpha[y][x]:
+                    pixels[y * width + index * ICON_SIZE + x] = color + (alpha[y][x],)
+    return width, ICON_SIZE, pixels
+
+
+def build_atlas(image_dir, out_path):
+    width, height, pixels = atlas_pixels(image_dir)
+    write_png_rgba(out_path, width, height, pixels)
+
+
+def atlas_is_current(image_dir, atlas_path):
+    """Whether atlas_path holds exactly the pixels build_atlas would write.
+
+    Pixels are compared rather than bytes, since zlib output may differ
+    between Python builds."""
+    if not os.path.exists(atlas_path):
+        return False
+    return read_png_rgba(atlas_path) == atlas_pixels(image_dir)
+
+
+if __name__ == '__main__':
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    image_dir = os.path.join(root, 'resources', 'images')
+    build_atlas(image_dir, os.path.join(image_dir, ATLAS_NAME))
+    sys.exit(0)